@@ -40,6 +40,21 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// euclidean_many_rcpp
+arma::mat euclidean_many_rcpp(arma::mat query, arma::mat base, int mode, double threshold, int threads);
+RcppExport SEXP _rTLS_euclidean_many_rcpp(SEXP querySEXP, SEXP baseSEXP, SEXP modeSEXP, SEXP thresholdSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type query(querySEXP);
+    Rcpp::traits::input_parameter< arma::mat >::type base(baseSEXP);
+    Rcpp::traits::input_parameter< int >::type mode(modeSEXP);
+    Rcpp::traits::input_parameter< double >::type threshold(thresholdSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(euclidean_many_rcpp(query, base, mode, threshold, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // euclidean_rcpp
 Rcpp::NumericVector euclidean_rcpp(Rcpp::NumericVector sample, Rcpp::NumericMatrix base, int threads);
 RcppExport SEXP _rTLS_euclidean_rcpp(SEXP sampleSEXP, SEXP baseSEXP, SEXP threadsSEXP) {
@@ -83,6 +98,38 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// ground_rcpp
+arma::mat ground_rcpp(arma::mat cloud, double resolution, int threads);
+RcppExport SEXP _rTLS_ground_rcpp(SEXP cloudSEXP, SEXP resolutionSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< double >::type resolution(resolutionSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(ground_rcpp(cloud, resolution, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// icp_rcpp
+Rcpp::List icp_rcpp(arma::mat source, arma::mat target, arma::mat initial, arma::vec levels, double max_distance, int k, int max_iterations, double tolerance, int threads);
+RcppExport SEXP _rTLS_icp_rcpp(SEXP sourceSEXP, SEXP targetSEXP, SEXP initialSEXP, SEXP levelsSEXP, SEXP max_distanceSEXP, SEXP kSEXP, SEXP max_iterationsSEXP, SEXP toleranceSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type source(sourceSEXP);
+    Rcpp::traits::input_parameter< arma::mat >::type target(targetSEXP);
+    Rcpp::traits::input_parameter< arma::mat >::type initial(initialSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type levels(levelsSEXP);
+    Rcpp::traits::input_parameter< double >::type max_distance(max_distanceSEXP);
+    Rcpp::traits::input_parameter< int >::type k(kSEXP);
+    Rcpp::traits::input_parameter< int >::type max_iterations(max_iterationsSEXP);
+    Rcpp::traits::input_parameter< double >::type tolerance(toleranceSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(icp_rcpp(source, target, initial, levels, max_distance, k, max_iterations, tolerance, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // line_AABB_rcpp
 arma::vec line_AABB_rcpp(arma::mat orig, arma::mat end, arma::vec AABB_min, arma::vec AABB_max);
 RcppExport SEXP _rTLS_line_AABB_rcpp(SEXP origSEXP, SEXP endSEXP, SEXP AABB_minSEXP, SEXP AABB_maxSEXP) {
@@ -127,6 +174,88 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// min_distance_rcpp
+Rcpp::List min_distance_rcpp(arma::mat cloud, int breaks, int threads, SEXP index);
+RcppExport SEXP _rTLS_min_distance_rcpp(SEXP cloudSEXP, SEXP breaksSEXP, SEXP threadsSEXP, SEXP indexSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< int >::type breaks(breaksSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    rcpp_result_gen = Rcpp::wrap(min_distance_rcpp(cloud, breaks, threads, index));
+    return rcpp_result_gen;
+END_RCPP
+}
+// min_neighbors_rcpp
+Rcpp::LogicalVector min_neighbors_rcpp(arma::mat cloud, double radius, int min_neighbours, int threads, SEXP index);
+RcppExport SEXP _rTLS_min_neighbors_rcpp(SEXP cloudSEXP, SEXP radiusSEXP, SEXP min_neighboursSEXP, SEXP threadsSEXP, SEXP indexSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< double >::type radius(radiusSEXP);
+    Rcpp::traits::input_parameter< int >::type min_neighbours(min_neighboursSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    rcpp_result_gen = Rcpp::wrap(min_neighbors_rcpp(cloud, radius, min_neighbours, threads, index));
+    return rcpp_result_gen;
+END_RCPP
+}
+// morton_order_rcpp
+Rcpp::List morton_order_rcpp(arma::mat cloud, arma::vec edge_length, int threads);
+RcppExport SEXP _rTLS_morton_order_rcpp(SEXP cloudSEXP, SEXP edge_lengthSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type edge_length(edge_lengthSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(morton_order_rcpp(cloud, edge_length, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// normalize_heights_rcpp
+arma::vec normalize_heights_rcpp(arma::mat cloud, double resolution, int threads);
+RcppExport SEXP _rTLS_normalize_heights_rcpp(SEXP cloudSEXP, SEXP resolutionSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< double >::type resolution(resolutionSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(normalize_heights_rcpp(cloud, resolution, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// pipeline_rcpp
+Rcpp::List pipeline_rcpp(arma::mat cloud, Rcpp::List stages, int threads);
+RcppExport SEXP _rTLS_pipeline_rcpp(SEXP cloudSEXP, SEXP stagesSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< Rcpp::List >::type stages(stagesSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(pipeline_rcpp(cloud, stages, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// poisson_disk_rcpp
+Rcpp::IntegerVector poisson_disk_rcpp(arma::mat cloud, double distance, int threads, SEXP index);
+RcppExport SEXP _rTLS_poisson_disk_rcpp(SEXP cloudSEXP, SEXP distanceSEXP, SEXP threadsSEXP, SEXP indexSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< double >::type distance(distanceSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    rcpp_result_gen = Rcpp::wrap(poisson_disk_rcpp(cloud, distance, threads, index));
+    return rcpp_result_gen;
+END_RCPP
+}
 // polar_to_cartesian_rcpp
 NumericMatrix polar_to_cartesian_rcpp(NumericMatrix polar, int threads);
 RcppExport SEXP _rTLS_polar_to_cartesian_rcpp(SEXP polarSEXP, SEXP threadsSEXP) {
@@ -139,6 +268,90 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// profile_enable_rcpp
+bool profile_enable_rcpp(bool enable);
+RcppExport SEXP _rTLS_profile_enable_rcpp(SEXP enableSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< bool >::type enable(enableSEXP);
+    rcpp_result_gen = Rcpp::wrap(profile_enable_rcpp(enable));
+    return rcpp_result_gen;
+END_RCPP
+}
+// profile_report_rcpp
+Rcpp::List profile_report_rcpp();
+RcppExport SEXP _rTLS_profile_report_rcpp() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(profile_report_rcpp());
+    return rcpp_result_gen;
+END_RCPP
+}
+// random_fraction_rcpp
+Rcpp::IntegerVector random_fraction_rcpp(int npoints, double fraction, double seed, int threads);
+RcppExport SEXP _rTLS_random_fraction_rcpp(SEXP npointsSEXP, SEXP fractionSEXP, SEXP seedSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type npoints(npointsSEXP);
+    Rcpp::traits::input_parameter< double >::type fraction(fractionSEXP);
+    Rcpp::traits::input_parameter< double >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(random_fraction_rcpp(npoints, fraction, seed, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// range_image_filter_rcpp
+Rcpp::LogicalVector range_image_filter_rcpp(arma::mat cloud, Rcpp::IntegerVector cell, arma::vec range, arma::vec dims, bool wrap, double radius, int min_neighbours, int window, int threads);
+RcppExport SEXP _rTLS_range_image_filter_rcpp(SEXP cloudSEXP, SEXP cellSEXP, SEXP rangeSEXP, SEXP dimsSEXP, SEXP wrapSEXP, SEXP radiusSEXP, SEXP min_neighboursSEXP, SEXP windowSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type cell(cellSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type range(rangeSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type dims(dimsSEXP);
+    Rcpp::traits::input_parameter< bool >::type wrap(wrapSEXP);
+    Rcpp::traits::input_parameter< double >::type radius(radiusSEXP);
+    Rcpp::traits::input_parameter< int >::type min_neighbours(min_neighboursSEXP);
+    Rcpp::traits::input_parameter< int >::type window(windowSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(range_image_filter_rcpp(cloud, cell, range, dims, wrap, radius, min_neighbours, window, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// range_image_rcpp
+Rcpp::List range_image_rcpp(arma::mat cloud, arma::vec anchor, arma::vec resolution, arma::vec frame, int threads);
+RcppExport SEXP _rTLS_range_image_rcpp(SEXP cloudSEXP, SEXP anchorSEXP, SEXP resolutionSEXP, SEXP frameSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type anchor(anchorSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type resolution(resolutionSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type frame(frameSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(range_image_rcpp(cloud, anchor, resolution, frame, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// raster_rcpp
+arma::mat raster_rcpp(arma::mat cloud, double resolution, arma::vec probs, bool fill, int threads);
+RcppExport SEXP _rTLS_raster_rcpp(SEXP cloudSEXP, SEXP resolutionSEXP, SEXP probsSEXP, SEXP fillSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< double >::type resolution(resolutionSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type probs(probsSEXP);
+    Rcpp::traits::input_parameter< bool >::type fill(fillSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(raster_rcpp(cloud, resolution, probs, fill, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // rotate2D_rcpp
 NumericMatrix rotate2D_rcpp(NumericMatrix plane, NumericVector angle, int threads);
 RcppExport SEXP _rTLS_rotate2D_rcpp(SEXP planeSEXP, SEXP angleSEXP, SEXP threadsSEXP) {
@@ -167,6 +380,237 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// shannon_boot_rcpp
+arma::vec shannon_boot_rcpp(arma::vec counts, int R, double conf, int threads);
+RcppExport SEXP _rTLS_shannon_boot_rcpp(SEXP countsSEXP, SEXP RSEXP, SEXP confSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::vec >::type counts(countsSEXP);
+    Rcpp::traits::input_parameter< int >::type R(RSEXP);
+    Rcpp::traits::input_parameter< double >::type conf(confSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(shannon_boot_rcpp(counts, R, conf, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// sor_filter_rcpp
+Rcpp::LogicalVector sor_filter_rcpp(arma::mat cloud, int k, double nSigma, int threads, SEXP index);
+RcppExport SEXP _rTLS_sor_filter_rcpp(SEXP cloudSEXP, SEXP kSEXP, SEXP nSigmaSEXP, SEXP threadsSEXP, SEXP indexSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< int >::type k(kSEXP);
+    Rcpp::traits::input_parameter< double >::type nSigma(nSigmaSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    rcpp_result_gen = Rcpp::wrap(sor_filter_rcpp(cloud, k, nSigma, threads, index));
+    return rcpp_result_gen;
+END_RCPP
+}
+// spatial_index_info_rcpp
+arma::vec spatial_index_info_rcpp(SEXP index);
+RcppExport SEXP _rTLS_spatial_index_info_rcpp(SEXP indexSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    rcpp_result_gen = Rcpp::wrap(spatial_index_info_rcpp(index));
+    return rcpp_result_gen;
+END_RCPP
+}
+// spatial_index_knn_rcpp
+arma::mat spatial_index_knn_rcpp(SEXP index, arma::mat query, int k, bool same, int threads);
+RcppExport SEXP _rTLS_spatial_index_knn_rcpp(SEXP indexSEXP, SEXP querySEXP, SEXP kSEXP, SEXP sameSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< arma::mat >::type query(querySEXP);
+    Rcpp::traits::input_parameter< int >::type k(kSEXP);
+    Rcpp::traits::input_parameter< bool >::type same(sameSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(spatial_index_knn_rcpp(index, query, k, same, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// spatial_index_load_rcpp
+SEXP spatial_index_load_rcpp(std::string file);
+RcppExport SEXP _rTLS_spatial_index_load_rcpp(SEXP fileSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type file(fileSEXP);
+    rcpp_result_gen = Rcpp::wrap(spatial_index_load_rcpp(file));
+    return rcpp_result_gen;
+END_RCPP
+}
+// spatial_index_radius_rcpp
+arma::mat spatial_index_radius_rcpp(SEXP index, arma::mat query, double radius, int max_neighbour, bool same, int threads);
+RcppExport SEXP _rTLS_spatial_index_radius_rcpp(SEXP indexSEXP, SEXP querySEXP, SEXP radiusSEXP, SEXP max_neighbourSEXP, SEXP sameSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< arma::mat >::type query(querySEXP);
+    Rcpp::traits::input_parameter< double >::type radius(radiusSEXP);
+    Rcpp::traits::input_parameter< int >::type max_neighbour(max_neighbourSEXP);
+    Rcpp::traits::input_parameter< bool >::type same(sameSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(spatial_index_radius_rcpp(index, query, radius, max_neighbour, same, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// spatial_index_rcpp
+SEXP spatial_index_rcpp(arma::mat cloud, int threads);
+RcppExport SEXP _rTLS_spatial_index_rcpp(SEXP cloudSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(spatial_index_rcpp(cloud, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// spatial_index_save_rcpp
+bool spatial_index_save_rcpp(SEXP index, std::string file);
+RcppExport SEXP _rTLS_spatial_index_save_rcpp(SEXP indexSEXP, SEXP fileSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type index(indexSEXP);
+    Rcpp::traits::input_parameter< std::string >::type file(fileSEXP);
+    rcpp_result_gen = Rcpp::wrap(spatial_index_save_rcpp(index, file));
+    return rcpp_result_gen;
+END_RCPP
+}
+// stand_summary_rcpp
+arma::mat stand_summary_rcpp(arma::mat cloud, Rcpp::IntegerVector start, Rcpp::IntegerVector points, Rcpp::IntegerVector tiles, arma::mat edge_sizes, int threads);
+RcppExport SEXP _rTLS_stand_summary_rcpp(SEXP cloudSEXP, SEXP startSEXP, SEXP pointsSEXP, SEXP tilesSEXP, SEXP edge_sizesSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type start(startSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type points(pointsSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type tiles(tilesSEXP);
+    Rcpp::traits::input_parameter< arma::mat >::type edge_sizes(edge_sizesSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(stand_summary_rcpp(cloud, start, points, tiles, edge_sizes, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// trunk_slices_rcpp
+arma::mat trunk_slices_rcpp(arma::mat cloud, double thickness, int section, int threads);
+RcppExport SEXP _rTLS_trunk_slices_rcpp(SEXP cloudSEXP, SEXP thicknessSEXP, SEXP sectionSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< double >::type thickness(thicknessSEXP);
+    Rcpp::traits::input_parameter< int >::type section(sectionSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(trunk_slices_rcpp(cloud, thickness, section, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// voxel_aggregate_rcpp
+arma::mat voxel_aggregate_rcpp(arma::mat values, Rcpp::IntegerVector start, Rcpp::IntegerVector points, int threads);
+RcppExport SEXP _rTLS_voxel_aggregate_rcpp(SEXP valuesSEXP, SEXP startSEXP, SEXP pointsSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type values(valuesSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type start(startSEXP);
+    Rcpp::traits::input_parameter< Rcpp::IntegerVector >::type points(pointsSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(voxel_aggregate_rcpp(values, start, points, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// voxel_components_rcpp
+Rcpp::List voxel_components_rcpp(arma::mat cloud, arma::vec edge_length, int connectivity, int threads);
+RcppExport SEXP _rTLS_voxel_components_rcpp(SEXP cloudSEXP, SEXP edge_lengthSEXP, SEXP connectivitySEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type edge_length(edge_lengthSEXP);
+    Rcpp::traits::input_parameter< int >::type connectivity(connectivitySEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(voxel_components_rcpp(cloud, edge_length, connectivity, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// voxel_counts_rcpp
+arma::mat voxel_counts_rcpp(arma::mat cloud, arma::vec edge_length, int threads);
+RcppExport SEXP _rTLS_voxel_counts_rcpp(SEXP cloudSEXP, SEXP edge_lengthSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type edge_length(edge_lengthSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(voxel_counts_rcpp(cloud, edge_length, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// voxel_index_rcpp
+Rcpp::List voxel_index_rcpp(arma::mat cloud, arma::vec edge_length, int threads);
+RcppExport SEXP _rTLS_voxel_index_rcpp(SEXP cloudSEXP, SEXP edge_lengthSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type edge_length(edge_lengthSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(voxel_index_rcpp(cloud, edge_length, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// voxel_mesh_rcpp
+Rcpp::List voxel_mesh_rcpp(arma::mat voxels, arma::vec edge_length, bool cull, int threads);
+RcppExport SEXP _rTLS_voxel_mesh_rcpp(SEXP voxelsSEXP, SEXP edge_lengthSEXP, SEXP cullSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type voxels(voxelsSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type edge_length(edge_lengthSEXP);
+    Rcpp::traits::input_parameter< bool >::type cull(cullSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(voxel_mesh_rcpp(voxels, edge_length, cull, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// voxel_subsample_rcpp
+Rcpp::IntegerVector voxel_subsample_rcpp(arma::mat cloud, arma::vec edge_length, int type, int threads);
+RcppExport SEXP _rTLS_voxel_subsample_rcpp(SEXP cloudSEXP, SEXP edge_lengthSEXP, SEXP typeSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type edge_length(edge_lengthSEXP);
+    Rcpp::traits::input_parameter< int >::type type(typeSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(voxel_subsample_rcpp(cloud, edge_length, type, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
+// voxel_summary_rcpp
+arma::mat voxel_summary_rcpp(arma::mat cloud, arma::vec edge_sizes, int threads);
+RcppExport SEXP _rTLS_voxel_summary_rcpp(SEXP cloudSEXP, SEXP edge_sizesSEXP, SEXP threadsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< arma::mat >::type cloud(cloudSEXP);
+    Rcpp::traits::input_parameter< arma::vec >::type edge_sizes(edge_sizesSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    rcpp_result_gen = Rcpp::wrap(voxel_summary_rcpp(cloud, edge_sizes, threads));
+    return rcpp_result_gen;
+END_RCPP
+}
 // voxelization_rcpp
 arma::mat voxelization_rcpp(arma::mat cloud, arma::vec edge_length, int threads);
 RcppExport SEXP _rTLS_voxelization_rcpp(SEXP cloudSEXP, SEXP edge_lengthSEXP, SEXP threadsSEXP) {
@@ -184,15 +628,47 @@ END_RCPP
 static const R_CallMethodDef CallEntries[] = {
     {"_rTLS_cartesian_to_polar_rcpp", (DL_FUNC) &_rTLS_cartesian_to_polar_rcpp, 3},
     {"_rTLS_circleRANSAC_rcpp", (DL_FUNC) &_rTLS_circleRANSAC_rcpp, 6},
+    {"_rTLS_euclidean_many_rcpp", (DL_FUNC) &_rTLS_euclidean_many_rcpp, 5},
     {"_rTLS_euclidean_rcpp", (DL_FUNC) &_rTLS_euclidean_rcpp, 3},
     {"_rTLS_features_knn_rcpp", (DL_FUNC) &_rTLS_features_knn_rcpp, 5},
     {"_rTLS_features_radius_rcpp", (DL_FUNC) &_rTLS_features_radius_rcpp, 5},
+    {"_rTLS_ground_rcpp", (DL_FUNC) &_rTLS_ground_rcpp, 3},
+    {"_rTLS_icp_rcpp", (DL_FUNC) &_rTLS_icp_rcpp, 9},
     {"_rTLS_line_AABB_rcpp", (DL_FUNC) &_rTLS_line_AABB_rcpp, 4},
     {"_rTLS_lines_interception_rcpp", (DL_FUNC) &_rTLS_lines_interception_rcpp, 6},
     {"_rTLS_meanDis_knn_rcpp", (DL_FUNC) &_rTLS_meanDis_knn_rcpp, 4},
+    {"_rTLS_min_distance_rcpp", (DL_FUNC) &_rTLS_min_distance_rcpp, 4},
+    {"_rTLS_min_neighbors_rcpp", (DL_FUNC) &_rTLS_min_neighbors_rcpp, 5},
+    {"_rTLS_morton_order_rcpp", (DL_FUNC) &_rTLS_morton_order_rcpp, 3},
+    {"_rTLS_normalize_heights_rcpp", (DL_FUNC) &_rTLS_normalize_heights_rcpp, 3},
+    {"_rTLS_pipeline_rcpp", (DL_FUNC) &_rTLS_pipeline_rcpp, 3},
+    {"_rTLS_poisson_disk_rcpp", (DL_FUNC) &_rTLS_poisson_disk_rcpp, 4},
     {"_rTLS_polar_to_cartesian_rcpp", (DL_FUNC) &_rTLS_polar_to_cartesian_rcpp, 2},
+    {"_rTLS_profile_enable_rcpp", (DL_FUNC) &_rTLS_profile_enable_rcpp, 1},
+    {"_rTLS_profile_report_rcpp", (DL_FUNC) &_rTLS_profile_report_rcpp, 0},
+    {"_rTLS_random_fraction_rcpp", (DL_FUNC) &_rTLS_random_fraction_rcpp, 4},
+    {"_rTLS_range_image_filter_rcpp", (DL_FUNC) &_rTLS_range_image_filter_rcpp, 9},
+    {"_rTLS_range_image_rcpp", (DL_FUNC) &_rTLS_range_image_rcpp, 5},
+    {"_rTLS_raster_rcpp", (DL_FUNC) &_rTLS_raster_rcpp, 5},
     {"_rTLS_rotate2D_rcpp", (DL_FUNC) &_rTLS_rotate2D_rcpp, 3},
     {"_rTLS_rotate3D_rcpp", (DL_FUNC) &_rTLS_rotate3D_rcpp, 5},
+    {"_rTLS_shannon_boot_rcpp", (DL_FUNC) &_rTLS_shannon_boot_rcpp, 4},
+    {"_rTLS_sor_filter_rcpp", (DL_FUNC) &_rTLS_sor_filter_rcpp, 5},
+    {"_rTLS_spatial_index_info_rcpp", (DL_FUNC) &_rTLS_spatial_index_info_rcpp, 1},
+    {"_rTLS_spatial_index_knn_rcpp", (DL_FUNC) &_rTLS_spatial_index_knn_rcpp, 5},
+    {"_rTLS_spatial_index_load_rcpp", (DL_FUNC) &_rTLS_spatial_index_load_rcpp, 1},
+    {"_rTLS_spatial_index_radius_rcpp", (DL_FUNC) &_rTLS_spatial_index_radius_rcpp, 6},
+    {"_rTLS_spatial_index_rcpp", (DL_FUNC) &_rTLS_spatial_index_rcpp, 2},
+    {"_rTLS_spatial_index_save_rcpp", (DL_FUNC) &_rTLS_spatial_index_save_rcpp, 2},
+    {"_rTLS_stand_summary_rcpp", (DL_FUNC) &_rTLS_stand_summary_rcpp, 6},
+    {"_rTLS_trunk_slices_rcpp", (DL_FUNC) &_rTLS_trunk_slices_rcpp, 4},
+    {"_rTLS_voxel_aggregate_rcpp", (DL_FUNC) &_rTLS_voxel_aggregate_rcpp, 4},
+    {"_rTLS_voxel_components_rcpp", (DL_FUNC) &_rTLS_voxel_components_rcpp, 4},
+    {"_rTLS_voxel_counts_rcpp", (DL_FUNC) &_rTLS_voxel_counts_rcpp, 3},
+    {"_rTLS_voxel_index_rcpp", (DL_FUNC) &_rTLS_voxel_index_rcpp, 3},
+    {"_rTLS_voxel_mesh_rcpp", (DL_FUNC) &_rTLS_voxel_mesh_rcpp, 4},
+    {"_rTLS_voxel_subsample_rcpp", (DL_FUNC) &_rTLS_voxel_subsample_rcpp, 4},
+    {"_rTLS_voxel_summary_rcpp", (DL_FUNC) &_rTLS_voxel_summary_rcpp, 3},
     {"_rTLS_voxelization_rcpp", (DL_FUNC) &_rTLS_voxelization_rcpp, 3},
     {NULL, NULL, 0}
 };
@@ -3,17 +3,14 @@
 #endif
 // [[Rcpp::plugins(openmp)]]
 #include <Rcpp.h>
+#include "core/threads.h"
 
 using namespace Rcpp;
 
 // [[Rcpp::export]]
 NumericMatrix cartesian_to_polar_rcpp(NumericMatrix cartesian, NumericVector anchor, int threads = 1) {
 
-#ifdef _OPENMP
-   if ( threads > 0 ) {
-      omp_set_num_threads( threads );
-   }
-#endif
+   ThreadGuard guard(threads);
 
    NumericMatrix polar(cartesian.nrow(), 3);
 
@@ -5,18 +5,17 @@
 // [[Rcpp::depends(RcppArmadillo"]]
 
 #include <RcppArmadillo.h>
-#include <RcppArmadilloExtensions/sample.h>
+#include <numeric>
+#include <vector>
+#include "core/splitmix.h"
+#include "core/threads.h"
 
 using namespace arma;
 
 // [[Rcpp::export]]
 arma::mat circleRANSAC_rcpp(arma::mat cloud, double fpoints, double z_value, arma::vec poutlier, int max_iterations, int threads = 1) {
 
-#ifdef _OPENMP
-  if ( threads > 1 ) {
-    omp_set_num_threads( threads );
-  }
-#endif
+  ThreadGuard guard(threads);
 
   int npoints = cloud.n_rows; //n of points in the cloud
   double npoints_double = npoints;
@@ -26,10 +25,26 @@ arma::mat circleRANSAC_rcpp(arma::mat cloud, double fpoints, double z_value, arm
 
   arma::mat xyr(max_iterations, 6); //Results to storage the iteration results
 
-#pragma omp parallel for
+  //Seed from the R generator so set.seed() is respected, each iteration draws its own stream
+  uint64_t seed = (uint64_t) (unif_rand()*4294967296.0) << 32 | (uint64_t) (unif_rand()*4294967296.0);
+
+#pragma omp parallel
+{
+  std::vector<arma::uword> order(npoints);
+
+#pragma omp for schedule(dynamic, 16)
   for(int i = 0; i < max_iterations; i++) { //loop of iterations
 
-    arma::uvec samp = arma::randperm(npoints, an_samples); //select random number of samples
+    //Partial Fisher-Yates shuffle to select random number of samples
+    SplitMix rng(seed ^ ((uint64_t) i * 0xD1B54A32D192ED03ULL));
+    std::iota(order.begin(), order.end(), 0);
+    arma::uvec samp(an_samples);
+    for(int j = 0; j < an_samples; j++) {
+      int pick = j + std::min((int) (rng.uniform()*(npoints - j)), npoints - j - 1);
+      std::swap(order[j], order[pick]);
+      samp(j) = order[j];
+    }
+
     arma::mat train_base = cloud.rows(samp); //subset values
 
     train_base.resize(an_samples, 3); //reside the matrix
@@ -75,6 +90,7 @@ arma::mat circleRANSAC_rcpp(arma::mat cloud, double fpoints, double z_value, arm
     xyr(i,4) = int_out; //Internal proportion of outliers
     xyr(i,5) = ext_out; //External proportion of outliers
   }
+}
 
   arma::vec internal = xyr.col(4);
   xyr = xyr.rows(find(internal <= int_outliers)); //Subset by the internal
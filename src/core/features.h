@@ -0,0 +1,197 @@
+#ifndef CORE_FEATURES_H
+#define CORE_FEATURES_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "spatial_grid.h"
+
+//Eigenvalues of a symmetric 3x3 matrix in decreasing order, using the
+//trigonometric solution of the characteristic polynomial
+inline void eigen_symmetric3(const double* c, double* values) {
+
+  //c holds xx, xy, xz, yy, yz, zz
+  double p1 = c[1]*c[1] + c[2]*c[2] + c[4]*c[4];
+  double q = (c[0] + c[3] + c[5])/3;
+
+  if (p1 == 0) {
+    values[0] = c[0];
+    values[1] = c[3];
+    values[2] = c[5];
+    std::sort(values, values + 3, [](double a, double b) { return a > b; });
+    return;
+  }
+
+  double p2 = (c[0] - q)*(c[0] - q) + (c[3] - q)*(c[3] - q) + (c[5] - q)*(c[5] - q) + 2*p1;
+  double p = std::sqrt(p2/6);
+
+  double b00 = (c[0] - q)/p, b11 = (c[3] - q)/p, b22 = (c[5] - q)/p;
+  double b01 = c[1]/p, b02 = c[2]/p, b12 = c[4]/p;
+
+  double r = (b00*(b11*b22 - b12*b12) - b01*(b01*b22 - b12*b02) + b02*(b01*b12 - b11*b02))/2;
+  r = std::max(-1.0, std::min(1.0, r));
+
+  double phi = std::acos(r)/3;
+
+  values[0] = q + 2*p*std::cos(phi);
+  values[2] = q + 2*p*std::cos(phi + 2.0943951023931957); //2*pi/3
+  values[1] = 3*q - values[0] - values[2];
+}
+
+//Unit eigenvector of a symmetric 3x3 matrix for one of its eigenvalues, as the
+//largest cross product of the rows of c - value*I
+inline void eigen_vector3(const double* c, double value, double* vector) {
+
+  double r[3][3] = {{c[0] - value, c[1], c[2]},
+                    {c[1], c[3] - value, c[4]},
+                    {c[2], c[4], c[5] - value}};
+
+  double best = 0;
+  vector[0] = 0;
+  vector[1] = 0;
+  vector[2] = 1;
+
+  for (int a = 0; a < 3; a++) {
+    const double* u = r[a];
+    const double* v = r[(a + 1) % 3];
+    double w[3] = {u[1]*v[2] - u[2]*v[1], u[2]*v[0] - u[0]*v[2], u[0]*v[1] - u[1]*v[0]};
+    double norm = w[0]*w[0] + w[1]*w[1] + w[2]*w[2];
+    if (norm > best) {
+      best = norm;
+      norm = std::sqrt(norm);
+      vector[0] = w[0]/norm;
+      vector[1] = w[1]/norm;
+      vector[2] = w[2]/norm;
+    }
+  }
+}
+
+//Covariance of the k nearest neighbors of the point at position s of the
+//grid, including the point. position maps the cloud to the grid. Returns the
+//number of neighbors found.
+inline int knn_covariance(const SpatialGrid& grid, const std::vector<int>& position, int s, int k,
+                          int* idx, double* d2, double* cov) {
+
+  const double* q = &grid.xyz[3*(size_t) s];
+  int found = grid.knn(q[0], q[1], q[2], k, -1, idx, d2);
+
+  if (found <= 3) {
+    return found;
+  }
+
+  //Covariance of the neighbors centered on their mean
+  double mean[3] = {0, 0, 0};
+
+  for (int j = 0; j < found; j++) {
+    idx[j] = position[idx[j]];
+    for (int a = 0; a < 3; a++) {
+      mean[a] += grid.xyz[3*(size_t) idx[j] + a];
+    }
+  }
+
+  for (int a = 0; a < 3; a++) {
+    mean[a] /= found;
+  }
+
+  for (int a = 0; a < 6; a++) {
+    cov[a] = 0;
+  }
+
+  for (int j = 0; j < found; j++) {
+    const double* p = &grid.xyz[3*(size_t) idx[j]];
+    double ex = p[0] - mean[0];
+    double ey = p[1] - mean[1];
+    double ez = p[2] - mean[2];
+    cov[0] += ex*ex; cov[1] += ex*ey; cov[2] += ex*ez;
+    cov[3] += ey*ey; cov[4] += ey*ez; cov[5] += ez*ez;
+  }
+
+  return found;
+}
+
+//Position of each point of the cloud on the grid
+inline void grid_position(const SpatialGrid& grid, std::vector<int>& position) {
+  position.resize(grid.n);
+  for (int s = 0; s < grid.n; s++) {
+    position[grid.id[s]] = s;
+  }
+}
+
+//Eigenvalues of the covariance of the k nearest neighbors of each point,
+//including the point, divided by their sum as in geometry_features. features
+//receives three values per point in the order of the cloud, or NaN if the
+//point has less than four neighbors.
+inline void knn_features(const SpatialGrid& grid, int k, std::vector<double>& features) {
+
+  int npoints = grid.n;
+
+  features.assign(3*(size_t) npoints, std::numeric_limits<double>::quiet_NaN());
+
+  std::vector<int> position;
+  grid_position(grid, position);
+
+#pragma omp parallel
+{
+  std::vector<int> idx(k);
+  std::vector<double> d2(k);
+
+#pragma omp for schedule(dynamic, 256)
+  for (int s = 0; s < npoints; s++) {
+
+    double cov[6];
+    int found = knn_covariance(grid, position, s, k, idx.data(), d2.data(), cov);
+
+    if (found <= 3) {
+      continue;
+    }
+
+    double values[3];
+    eigen_symmetric3(cov, values);
+
+    double total = values[0] + values[1] + values[2];
+    int i = grid.id[s];
+
+    for (int a = 0; a < 3; a++) {
+      features[3*(size_t) i + a] = values[a]/total;
+    }
+  }
+}
+}
+
+//Normals of the points as the eigenvector of the smallest eigenvalue of the
+//covariance of their k nearest neighbors. normals receives three values per
+//point in the order of the cloud, or NaN if the point has less than four
+//neighbors.
+inline void knn_normals(const SpatialGrid& grid, int k, std::vector<double>& normals) {
+
+  int npoints = grid.n;
+
+  normals.assign(3*(size_t) npoints, std::numeric_limits<double>::quiet_NaN());
+
+  std::vector<int> position;
+  grid_position(grid, position);
+
+#pragma omp parallel
+{
+  std::vector<int> idx(k);
+  std::vector<double> d2(k);
+
+#pragma omp for schedule(dynamic, 256)
+  for (int s = 0; s < npoints; s++) {
+
+    double cov[6];
+    int found = knn_covariance(grid, position, s, k, idx.data(), d2.data(), cov);
+
+    if (found <= 3) {
+      continue;
+    }
+
+    double values[3];
+    eigen_symmetric3(cov, values);
+    eigen_vector3(cov, values[2], &normals[3*(size_t) grid.id[s]]);
+  }
+}
+}
+
+#endif
@@ -0,0 +1,355 @@
+#ifndef CORE_ICP_H
+#define CORE_ICP_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "spatial_grid.h"
+#include "features.h"
+#include "subsample.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//Settings of the registration. Levels are the minimum distances between the
+//source points of each level from coarse to fine, 0 uses all the points.
+struct IcpSettings {
+  std::vector<double> levels;
+  double max_distance = 1;   //Largest distance of a correspondence
+  int k = 10;                //Neighbors of the normals of the target
+  int max_iterations = 50;   //Iterations per level
+  double tolerance = 1e-6;   //Smallest rotation (radians) and translation of an iteration
+};
+
+//Iterations of a level
+struct IcpLevel {
+  double distance = 0;
+  int points = 0;
+  int iterations = 0;
+  int correspondences = 0;
+  double rmse = 0;           //Point to plane root mean square error of the last iteration
+};
+
+struct IcpResult {
+  double transform[16];      //Row major 4x4 transform of the source to the target
+  std::vector<IcpLevel> levels;
+  int correspondences = 0;   //Source points with a target point within max_distance
+  double overlap = 0;        //Fraction of source points with a correspondence
+  double rmse = 0;           //Point to plane errors of the correspondences
+  double mean = 0;           //Point to point distances of the correspondences
+  double median = 0;
+};
+
+//Applies the row major transform t to a point
+inline void icp_apply(const double* t, const double* p, double* out) {
+  for (int a = 0; a < 3; a++) {
+    out[a] = t[4*a]*p[0] + t[4*a + 1]*p[1] + t[4*a + 2]*p[2] + t[4*a + 3];
+  }
+}
+
+//Solves the 6x6 system A x = b by Cholesky. Returns false if A is singular,
+//e.g. when all the correspondences are on a single plane.
+inline bool icp_solve(double* A, double* b, double* x) {
+
+  for (int j = 0; j < 6; j++) {
+    double d = A[6*j + j];
+    for (int m = 0; m < j; m++) {
+      d -= A[6*j + m]*A[6*j + m];
+    }
+    if (d <= 1e-12*(A[0] + A[7] + A[14] + A[21] + A[28] + A[35])) {
+      return false;
+    }
+    A[6*j + j] = std::sqrt(d);
+    for (int i = j + 1; i < 6; i++) {
+      double s = A[6*i + j];
+      for (int m = 0; m < j; m++) {
+        s -= A[6*i + m]*A[6*j + m];
+      }
+      A[6*i + j] = s/A[6*j + j];
+    }
+  }
+
+  for (int i = 0; i < 6; i++) {
+    double s = b[i];
+    for (int m = 0; m < i; m++) {
+      s -= A[6*i + m]*x[m];
+    }
+    x[i] = s/A[6*i + i];
+  }
+
+  for (int i = 5; i >= 0; i--) {
+    double s = x[i];
+    for (int m = i + 1; m < 6; m++) {
+      s -= A[6*m + i]*x[m];
+    }
+    x[i] = s/A[6*i + i];
+  }
+
+  return true;
+}
+
+//Median of the values, it reorders them
+inline double icp_median(std::vector<double>& values) {
+  if (values.empty()) {
+    return 0;
+  }
+  size_t half = values.size()/2;
+  std::nth_element(values.begin(), values.begin() + half, values.end());
+  return values[half];
+}
+
+//Target of the registration, with the normals of its points
+struct IcpTarget {
+  SpatialGrid grid;
+  std::vector<double> normals;  //Normals in the order of the cloud
+  std::vector<int> position;    //Position of each point of the cloud on the grid
+
+  void build(const double* X, const double* Y, const double* Z, int npoints, int k) {
+    grid.build(X, Y, Z, npoints);
+    knn_normals(grid, k, normals);
+    grid_position(grid, position);
+  }
+};
+
+//Closest target point with a normal within max_distance of each source point
+//after the transform. The search is bounded by max_distance, so source points
+//that do not overlap the target are rejected after a few cells. residuals receives the point to plane residual of each
+//source point, or NaN without a correspondence, and distances the point to
+//point distance. Returns the number of correspondences.
+inline int icp_match(const IcpTarget& target, const std::vector<double>& source, const double* transform,
+                     double max_distance, std::vector<int>& match, std::vector<double>& residuals,
+                     std::vector<double>& distances) {
+
+  int npoints = source.size()/3;
+  double max2 = max_distance*max_distance;
+  int correspondences = 0;
+
+  match.assign(npoints, -1);
+  residuals.assign(npoints, std::numeric_limits<double>::quiet_NaN());
+  distances.assign(npoints, std::numeric_limits<double>::quiet_NaN());
+
+#pragma omp parallel for schedule(dynamic, 256) reduction(+:correspondences)
+  for (int i = 0; i < npoints; i++) {
+
+    double p[3];
+    icp_apply(transform, &source[3*(size_t) i], p);
+
+    int idx;
+    double d2;
+    int found = target.grid.knn(p[0], p[1], p[2], 1, -1, &idx, &d2, max_distance);
+
+    if (found == 0 || d2 > max2 || std::isnan(target.normals[3*(size_t) idx])) {
+      continue;
+    }
+
+    const double* q = &target.grid.xyz[3*(size_t) target.position[idx]];
+    const double* n = &target.normals[3*(size_t) idx];
+
+    match[i] = idx;
+    residuals[i] = (p[0] - q[0])*n[0] + (p[1] - q[1])*n[1] + (p[2] - q[2])*n[2];
+    distances[i] = std::sqrt(d2);
+    correspondences++;
+  }
+
+  return correspondences;
+}
+
+//Point to plane ICP of the source points to the target. Each level subsamples
+//the source at a minimum distance, and each iteration matches the source to
+//the closest target point, weights the residuals with the Huber function on a
+//robust scale (1.4826 times their median absolute value), and solves the
+//linearized rotation and translation. result.transform holds the initial
+//transform and receives the result.
+inline void icp_register(const IcpTarget& target, const double* X, const double* Y, const double* Z, int npoints,
+                         const IcpSettings& settings, IcpResult& result) {
+
+  std::vector<double> levels = settings.levels;
+  if (levels.empty()) {
+    levels.push_back(0);
+  }
+
+  result.levels.clear();
+
+  std::vector<int> match;
+  std::vector<double> residuals;
+  std::vector<double> distances;
+  std::vector<double> scaled;
+
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+
+  for (size_t l = 0; l < levels.size(); l++) {
+
+    //Source points of the level
+    std::vector<int> selected;
+
+    if (levels[l] > 0) {
+      SpatialGrid grid(X, Y, Z, npoints, levels[l]);
+      poisson_disk(grid, levels[l], selected);
+    } else {
+      selected.resize(npoints);
+      for (int i = 0; i < npoints; i++) {
+        selected[i] = i;
+      }
+    }
+
+    int nsource = selected.size();
+    std::vector<double> source(3*(size_t) nsource);
+
+    for (int j = 0; j < nsource; j++) {
+      source[3*(size_t) j] = X[selected[j]];
+      source[3*(size_t) j + 1] = Y[selected[j]];
+      source[3*(size_t) j + 2] = Z[selected[j]];
+    }
+
+    IcpLevel level;
+    level.distance = levels[l];
+    level.points = nsource;
+
+    for (int it = 0; it < settings.max_iterations; it++) {
+
+      level.correspondences = icp_match(target, source, result.transform, settings.max_distance, match, residuals, distances);
+      level.iterations = it + 1;
+
+      if (level.correspondences < 6) {
+        break;
+      }
+
+      //Robust scale of the residuals
+      scaled.clear();
+      double sum2 = 0;
+      for (int i = 0; i < nsource; i++) {
+        if (match[i] >= 0) {
+          scaled.push_back(std::fabs(residuals[i]));
+          sum2 += residuals[i]*residuals[i];
+        }
+      }
+
+      level.rmse = std::sqrt(sum2/level.correspondences);
+      double huber = 1.345*std::max(1.4826*icp_median(scaled), 1e-12);
+
+      //Normal equations of the linearized point to plane error, per thread
+      std::vector<double> normal(nthreads*42, 0);
+
+#pragma omp parallel num_threads(nthreads)
+{
+      int t = 0;
+#ifdef _OPENMP
+      t = omp_get_thread_num();
+#endif
+      double* A = &normal[42*t];
+      double* b = A + 36;
+
+#pragma omp for schedule(static)
+      for (int i = 0; i < nsource; i++) {
+
+        if (match[i] < 0) {
+          continue;
+        }
+
+        double p[3];
+        icp_apply(result.transform, &source[3*(size_t) i], p);
+        const double* n = &target.normals[3*(size_t) match[i]];
+
+        double r = residuals[i];
+        double w = (std::fabs(r) <= huber) ? 1 : huber/std::fabs(r);
+
+        //Derivatives for small rotations around X, Y, Z and the translation
+        double J[6] = {p[1]*n[2] - p[2]*n[1], p[2]*n[0] - p[0]*n[2], p[0]*n[1] - p[1]*n[0], n[0], n[1], n[2]};
+
+        for (int a = 0; a < 6; a++) {
+          for (int c = 0; c <= a; c++) {
+            A[6*a + c] += w*J[a]*J[c];
+          }
+          b[a] -= w*J[a]*r;
+        }
+      }
+}
+
+      double A[36] = {0};
+      double b[6] = {0};
+      for (int t = 0; t < nthreads; t++) {
+        for (int a = 0; a < 36; a++) {
+          A[a] += normal[42*t + a];
+        }
+        for (int a = 0; a < 6; a++) {
+          b[a] += normal[42*t + 36 + a];
+        }
+      }
+      for (int a = 0; a < 6; a++) {
+        for (int c = a + 1; c < 6; c++) {
+          A[6*a + c] = A[6*c + a];
+        }
+      }
+
+      double x[6];
+      if (!icp_solve(A, b, x)) {
+        break;
+      }
+
+      //Update with the exact rotation of the angles, R = Rz Ry Rx
+      double ca = std::cos(x[0]), sa = std::sin(x[0]);
+      double cb = std::cos(x[1]), sb = std::sin(x[1]);
+      double cg = std::cos(x[2]), sg = std::sin(x[2]);
+
+      double update[16] = {cg*cb, cg*sb*sa - sg*ca, cg*sb*ca + sg*sa, x[3],
+                           sg*cb, sg*sb*sa + cg*ca, sg*sb*ca - cg*sa, x[4],
+                           -sb, cb*sa, cb*ca, x[5],
+                           0, 0, 0, 1};
+
+      double composed[16];
+      for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+          composed[4*i + j] = 0;
+          for (int m = 0; m < 4; m++) {
+            composed[4*i + j] += update[4*i + m]*result.transform[4*m + j];
+          }
+        }
+      }
+      std::copy(composed, composed + 16, result.transform);
+
+      double rotation = std::sqrt(x[0]*x[0] + x[1]*x[1] + x[2]*x[2]);
+      double translation = std::sqrt(x[3]*x[3] + x[4]*x[4] + x[5]*x[5]);
+
+      if (rotation < settings.tolerance && translation < settings.tolerance) {
+        break;
+      }
+    }
+
+    result.levels.push_back(level);
+  }
+
+  //Residuals of all the source points with the final transform
+  std::vector<double> source(3*(size_t) npoints);
+  for (int i = 0; i < npoints; i++) {
+    source[3*(size_t) i] = X[i];
+    source[3*(size_t) i + 1] = Y[i];
+    source[3*(size_t) i + 2] = Z[i];
+  }
+
+  result.correspondences = icp_match(target, source, result.transform, settings.max_distance, match, residuals, distances);
+  result.overlap = (npoints > 0) ? (double) result.correspondences/npoints : 0;
+
+  double sum2 = 0;
+  double sum = 0;
+  scaled.clear();
+  for (int i = 0; i < npoints; i++) {
+    if (match[i] >= 0) {
+      sum2 += residuals[i]*residuals[i];
+      sum += distances[i];
+      scaled.push_back(distances[i]);
+    }
+  }
+
+  if (result.correspondences > 0) {
+    result.rmse = std::sqrt(sum2/result.correspondences);
+    result.mean = sum/result.correspondences;
+    result.median = icp_median(scaled);
+  }
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef CORE_MIN_NEIGHBORS_H
+#define CORE_MIN_NEIGHBORS_H
+
+#include <cmath>
+#include <vector>
+#include "spatial_grid.h"
+
+//Points with at least min_neighbours other points within radius are set to 1
+//in keep. Counting stops as soon as a point reaches min_neighbours. If dense,
+//the cells of the grid have a diagonal of at most radius, so all the points
+//of a cell are neighbors. The caller knows the cell it asked for, and
+//recomputing it from grid.cell does not round trip for every radius.
+inline void min_neighbors(const SpatialGrid& grid, double radius, int min_neighbours, bool dense, std::vector<char>& keep) {
+
+  int npoints = grid.n;
+
+  keep.assign(npoints, 0);
+
+  if (min_neighbours <= 0) {
+    keep.assign(npoints, 1);
+    return;
+  }
+
+  int ncells = grid.keys.size();
+
+#pragma omp parallel for schedule(dynamic, 64)
+  for (int c = 0; c < ncells; c++) {
+
+    int from = grid.start[c];
+    int to = grid.start[c + 1];
+
+    //Dense cells are accepted without any distance
+    if (dense && to - from - 1 >= min_neighbours) {
+      for (int s = from; s < to; s++) {
+        keep[grid.id[s]] = 1;
+      }
+      continue;
+    }
+
+    for (int s = from; s < to; s++) {
+      int count = grid.radius_count(grid.xyz[3*(size_t) s], grid.xyz[3*(size_t) s + 1], grid.xyz[3*(size_t) s + 2],
+                                    radius, grid.id[s], min_neighbours);
+      keep[grid.id[s]] = count >= min_neighbours;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef MORTON_H
+#define MORTON_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//Morton (Z-order) codes interleave 21 bits of each axis into 63 bits,
+//so points that are close in space are close in the order of the codes.
+static const int64_t MORTON_MAX = (int64_t) 1 << 21;
+
+inline uint64_t morton_spread(uint64_t v) {
+  v &= 0x1fffff;
+  v = (v | v << 32) & 0x1f00000000ffffULL;
+  v = (v | v << 16) & 0x1f0000ff0000ffULL;
+  v = (v | v << 8) & 0x100f00f00f00f00fULL;
+  v = (v | v << 4) & 0x10c30c30c30c30c3ULL;
+  v = (v | v << 2) & 0x1249249249249249ULL;
+  return v;
+}
+
+inline uint64_t morton_code(int64_t ix, int64_t iy, int64_t iz) {
+  return morton_spread(ix) | (morton_spread(iy) << 1) | (morton_spread(iz) << 2);
+}
+
+//True if the codes are already in order, so a sort can be skipped
+inline bool morton_sorted(const std::vector<uint64_t>& codes) {
+
+  int n = codes.size();
+  bool sorted = true;
+
+#pragma omp parallel for reduction(&&:sorted)
+  for (int i = 1; i < n; i++) {
+    sorted = sorted && codes[i - 1] <= codes[i];
+  }
+
+  return sorted;
+}
+
+//Stable LSD radix sort of the codes on 8 bit digits. order receives the
+//index of the points sorted by code, and codes are left sorted.
+inline void morton_sort(std::vector<uint64_t>& codes, std::vector<int>& order) {
+
+  int n = codes.size();
+
+  order.resize(n);
+  for (int i = 0; i < n; i++) {
+    order[i] = i;
+  }
+
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+
+  std::vector<uint64_t> codes_tmp(n);
+  std::vector<int> order_tmp(n);
+  std::vector<int64_t> counts(256*(size_t) nthreads);
+
+  for (int shift = 0; shift < 64; shift += 8) {
+
+    std::fill(counts.begin(), counts.end(), 0);
+
+    //Histogram of the digit on one contiguous chunk per thread
+#pragma omp parallel for schedule(static, 1)
+    for (int t = 0; t < nthreads; t++) {
+      int from = (int64_t) n*t/nthreads;
+      int to = (int64_t) n*(t + 1)/nthreads;
+      int64_t* count = &counts[256*(size_t) t];
+      for (int i = from; i < to; i++) {
+        count[(codes[i] >> shift) & 0xff]++;
+      }
+    }
+
+    //Digits with all the points in one bucket do not change the order
+    bool skip = false;
+    for (int d = 0; d < 256 && !skip; d++) {
+      int64_t total = 0;
+      for (int t = 0; t < nthreads; t++) {
+        total += counts[256*(size_t) t + d];
+      }
+      skip = total == n;
+    }
+
+    if (skip) {
+      continue;
+    }
+
+    //Offsets by digit, then by thread to keep the sort stable
+    int64_t offset = 0;
+    for (int d = 0; d < 256; d++) {
+      for (int t = 0; t < nthreads; t++) {
+        int64_t c = counts[256*(size_t) t + d];
+        counts[256*(size_t) t + d] = offset;
+        offset += c;
+      }
+    }
+
+#pragma omp parallel for schedule(static, 1)
+    for (int t = 0; t < nthreads; t++) {
+      int from = (int64_t) n*t/nthreads;
+      int to = (int64_t) n*(t + 1)/nthreads;
+      int64_t* next = &counts[256*(size_t) t];
+      for (int i = from; i < to; i++) {
+        int64_t pos = next[(codes[i] >> shift) & 0xff]++;
+        codes_tmp[pos] = codes[i];
+        order_tmp[pos] = order[i];
+      }
+    }
+
+    codes.swap(codes_tmp);
+    order.swap(order_tmp);
+  }
+}
+
+#endif
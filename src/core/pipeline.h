@@ -0,0 +1,333 @@
+#ifndef CORE_PIPELINE_H
+#define CORE_PIPELINE_H
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "spatial_grid.h"
+#include "sor.h"
+#include "min_neighbors.h"
+#include "voxel_counts.h"
+#include "voxel_summary.h"
+
+//Stages of a pipeline. Transforms, polar coordinates and selections are
+//applied point by point, so consecutive ones are fused in a single pass.
+//Filters need the neighbors of each point and voxels and summaries reduce
+//the cloud, so they run on the whole cloud left by the previous stages.
+enum PipelineStageType {
+  STAGE_TRANSFORM,      //Row major 3x4 affine transform
+  STAGE_POLAR,          //Anchor of the polar coordinates
+  STAGE_SELECT,         //Column, minimum and maximum of the points to keep
+  STAGE_SOR,            //k and nSigma
+  STAGE_MIN_NEIGHBORS,  //Radius and min_neighbours
+  STAGE_VOXELS,         //Edge length of the voxels
+  STAGE_SUMMARY
+};
+
+enum PipelineColumn {
+  COLUMN_X,
+  COLUMN_Y,
+  COLUMN_Z,
+  COLUMN_ZENITH,
+  COLUMN_AZIMUTH,
+  COLUMN_DISTANCE,
+  COLUMN_N
+};
+
+struct PipelineStage {
+  int type = STAGE_TRANSFORM;
+  std::vector<double> values;
+};
+
+//Points left by the stages, with the row of each point in the input cloud.
+//The polar columns are empty until a polar stage is run.
+struct PipelineCloud {
+  std::vector<double> columns[COLUMN_N];
+  std::vector<int> rows;
+  bool polar = false;
+
+  int size() const {
+    return rows.size();
+  }
+};
+
+enum PipelineOutput {
+  OUTPUT_CLOUD,
+  OUTPUT_VOXELS,
+  OUTPUT_SUMMARY
+};
+
+struct PipelineResult {
+  int output = OUTPUT_CLOUD;
+  PipelineCloud cloud;
+  Voxels voxels;
+  VoxelSummary summary;
+};
+
+//Points processed together in the fused passes
+static const int PIPELINE_CHUNK = 4096;
+
+inline bool pipeline_pointwise(int type) {
+  return type == STAGE_TRANSFORM || type == STAGE_POLAR || type == STAGE_SELECT;
+}
+
+//Transform b applied after a, both row major 3x4
+inline void pipeline_compose(const double* b, const double* a, double* out) {
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 4; j++) {
+      out[4*i + j] = b[4*i]*a[j] + b[4*i + 1]*a[4 + j] + b[4*i + 2]*a[8 + j] + (j == 3 ? b[4*i + 3] : 0);
+    }
+  }
+}
+
+//Keeps the points with keep set, in the same order. Chunks are compacted in
+//parallel at the offsets of the points kept by the previous chunks.
+inline void pipeline_compact(PipelineCloud& cloud, const std::vector<char>& keep) {
+
+  int npoints = cloud.size();
+  int nchunks = (npoints + PIPELINE_CHUNK - 1)/PIPELINE_CHUNK;
+
+  std::vector<int> offset(nchunks + 1, 0);
+
+#pragma omp parallel for
+  for (int c = 0; c < nchunks; c++) {
+    int end = std::min(npoints, (c + 1)*PIPELINE_CHUNK);
+    int count = 0;
+    for (int i = c*PIPELINE_CHUNK; i < end; i++) {
+      count += keep[i] != 0;
+    }
+    offset[c + 1] = count;
+  }
+
+  for (int c = 0; c < nchunks; c++) {
+    offset[c + 1] += offset[c];
+  }
+
+  int kept = offset[nchunks];
+
+  if (kept == npoints) {
+    return;
+  }
+
+  int ncolumns = cloud.polar ? COLUMN_N : 3;
+
+  PipelineCloud out;
+  out.polar = cloud.polar;
+  out.rows.resize(kept);
+  for (int b = 0; b < ncolumns; b++) {
+    out.columns[b].resize(kept);
+  }
+
+#pragma omp parallel for
+  for (int c = 0; c < nchunks; c++) {
+    int end = std::min(npoints, (c + 1)*PIPELINE_CHUNK);
+    int next = offset[c];
+    for (int i = c*PIPELINE_CHUNK; i < end; i++) {
+      if (keep[i]) {
+        for (int b = 0; b < ncolumns; b++) {
+          out.columns[b][next] = cloud.columns[b][i];
+        }
+        out.rows[next] = cloud.rows[i];
+        next++;
+      }
+    }
+  }
+
+  std::swap(cloud, out);
+}
+
+//Runs consecutive point by point stages in one pass over chunks of points.
+//Consecutive transforms are composed first, so each point is transformed once.
+inline void pipeline_fused(PipelineCloud& cloud, std::vector<PipelineStage> stages) {
+
+  //Compose the consecutive transforms
+  std::vector<PipelineStage> fused;
+
+  for (size_t s = 0; s < stages.size(); s++) {
+    if (stages[s].type == STAGE_TRANSFORM && !fused.empty() && fused.back().type == STAGE_TRANSFORM) {
+      std::vector<double> composed(12);
+      pipeline_compose(stages[s].values.data(), fused.back().values.data(), composed.data());
+      fused.back().values = composed;
+    } else {
+      fused.push_back(stages[s]);
+    }
+  }
+
+  int npoints = cloud.size();
+  int nstages = fused.size();
+  bool selects = false;
+
+  for (int s = 0; s < nstages; s++) {
+    if (fused[s].type == STAGE_POLAR && !cloud.polar) {
+      for (int b = 3; b < COLUMN_N; b++) {
+        cloud.columns[b].resize(npoints);
+      }
+      cloud.polar = true;
+    }
+    selects = selects || fused[s].type == STAGE_SELECT;
+  }
+
+  std::vector<char> keep(npoints, 1);
+  int ncolumns = cloud.polar ? COLUMN_N : 3;
+  int nchunks = (npoints + PIPELINE_CHUNK - 1)/PIPELINE_CHUNK;
+
+#pragma omp parallel for schedule(dynamic, 1)
+  for (int c = 0; c < nchunks; c++) {
+
+    int end = std::min(npoints, (c + 1)*PIPELINE_CHUNK);
+
+    for (int i = c*PIPELINE_CHUNK; i < end; i++) {
+
+      double p[COLUMN_N];
+      for (int b = 0; b < ncolumns; b++) {
+        p[b] = cloud.columns[b][i];
+      }
+
+      for (int s = 0; s < nstages && keep[i]; s++) {
+
+        const double* v = fused[s].values.data();
+
+        if (fused[s].type == STAGE_TRANSFORM) {
+          double x = p[0], y = p[1], z = p[2];
+          for (int a = 0; a < 3; a++) {
+            p[a] = v[4*a]*x + v[4*a + 1]*y + v[4*a + 2]*z + v[4*a + 3];
+          }
+        } else if (fused[s].type == STAGE_POLAR) {
+          //Zenith and azimuth (0 to 360) in degrees as in cartesian_to_polar
+          double dx = p[0] - v[0], dy = p[1] - v[1], dz = p[2] - v[2];
+          p[COLUMN_DISTANCE] = std::sqrt(dx*dx + dy*dy + dz*dz);
+          p[COLUMN_ZENITH] = std::acos(dz/p[COLUMN_DISTANCE])*57.29577951308232;
+          p[COLUMN_AZIMUTH] = std::atan2(dy, dx)*57.29577951308232;
+          if (p[COLUMN_AZIMUTH] < 0) {
+            p[COLUMN_AZIMUTH] += 360;
+          }
+        } else {
+          double value = p[(int) v[0]];
+          keep[i] = value >= v[1] && value <= v[2];
+        }
+      }
+
+      for (int b = 0; b < ncolumns; b++) {
+        cloud.columns[b][i] = p[b];
+      }
+    }
+  }
+
+  if (selects) {
+    pipeline_compact(cloud, keep);
+  }
+}
+
+//Runs the stages on the points XYZ. Returns false with the error if the
+//parameters of a stage do not fit the points left by the previous stages.
+inline bool pipeline_run(const double* X, const double* Y, const double* Z, int npoints,
+                         const std::vector<PipelineStage>& stages, PipelineResult& result, std::string& error) {
+
+  PipelineCloud& cloud = result.cloud;
+
+  cloud = PipelineCloud();
+  cloud.columns[COLUMN_X].assign(X, X + npoints);
+  cloud.columns[COLUMN_Y].assign(Y, Y + npoints);
+  cloud.columns[COLUMN_Z].assign(Z, Z + npoints);
+  cloud.rows.resize(npoints);
+
+  for (int i = 0; i < npoints; i++) {
+    cloud.rows[i] = i;
+  }
+
+  result.output = OUTPUT_CLOUD;
+
+  size_t s = 0;
+
+  while (s < stages.size()) {
+
+    if (result.output != OUTPUT_CLOUD && !(result.output == OUTPUT_VOXELS && stages[s].type == STAGE_SUMMARY)) {
+      error = "Only summary_voxels can follow the voxels";
+      return false;
+    }
+
+    if (pipeline_pointwise(stages[s].type)) {
+
+      size_t end = s;
+      while (end < stages.size() && pipeline_pointwise(stages[end].type)) {
+        end++;
+      }
+
+      pipeline_fused(cloud, std::vector<PipelineStage>(stages.begin() + s, stages.begin() + end));
+      s = end;
+      continue;
+    }
+
+    const PipelineStage& stage = stages[s];
+    const double* v = stage.values.data();
+    int n = cloud.size();
+
+    if (stage.type == STAGE_SOR || stage.type == STAGE_MIN_NEIGHBORS) {
+
+      std::vector<char> keep;
+
+      if (stage.type == STAGE_SOR) {
+        if (v[0] < 1 || v[0] >= n) {
+          error = "k needs to be between 1 and the number of points left - 1";
+          return false;
+        }
+        SpatialGrid grid(cloud.columns[0].data(), cloud.columns[1].data(), cloud.columns[2].data(), n);
+        sor_filter(grid, v[0], v[1], keep);
+      } else if (v[0] <= 0) {
+        error = "radius needs to be positive";
+        return false;
+      } else if (v[1] <= 0 || n == 0) {
+        keep.assign(n, 1);
+      } else {
+        //Cells with a diagonal equal to the radius, as in min_neighbors_rcpp
+        double cell = v[0]/std::sqrt(3.0);
+        SpatialGrid grid(cloud.columns[0].data(), cloud.columns[1].data(), cloud.columns[2].data(), n, cell);
+        min_neighbors(grid, v[0], v[1], grid.cell == cell, keep);
+      }
+
+      pipeline_compact(cloud, keep);
+
+    } else if (stage.type == STAGE_VOXELS && s + 1 < stages.size() && stages[s + 1].type == STAGE_SUMMARY) {
+
+      //Only the summary is returned, so it is reduced without building the voxels
+      if (n == 0) {
+        error = "No points are left to summarize";
+        return false;
+      }
+      if (!voxel_summary_points(cloud.columns[0].data(), cloud.columns[1].data(), cloud.columns[2].data(), n, v, result.summary)) {
+        error = "edge_length is too small for the extent of the cloud";
+        return false;
+      }
+      result.output = OUTPUT_SUMMARY;
+      s++;
+
+    } else if (stage.type == STAGE_VOXELS) {
+
+      if (!voxel_counts(cloud.columns[0].data(), cloud.columns[1].data(), cloud.columns[2].data(), n, v, result.voxels)) {
+        error = "edge_length is too small for the extent of the cloud";
+        return false;
+      }
+      result.output = OUTPUT_VOXELS;
+
+    } else if (stage.type == STAGE_SUMMARY) {
+
+      if (result.output != OUTPUT_VOXELS) {
+        error = "summary_voxels needs a voxels stage before it";
+        return false;
+      }
+      if (result.voxels.n.empty()) {
+        error = "No points are left to summarize";
+        return false;
+      }
+      result.summary = voxel_summary(result.voxels);
+      result.output = OUTPUT_SUMMARY;
+    }
+
+    s++;
+  }
+
+  return true;
+}
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//Phases timed by the kernels
+enum ProfilePhase {
+  PHASE_GROUP,
+  PHASE_GATHER,
+  PHASE_COVARIANCE,
+  PHASE_EIGEN,
+  PHASE_DISTANCE,
+  PHASE_INTERSECT,
+  PHASE_OUTPUT,
+  PHASE_N
+};
+
+static const char* const PROFILE_PHASES[PHASE_N] = {
+  "group", "gather", "covariance", "eigen", "distance", "intersect", "output"
+};
+
+//Counters of one thread, on their own cache line so threads do not share it
+struct alignas(64) ProfileCounters {
+  double seconds[PHASE_N];
+  double points;
+  double scratch;
+};
+
+//Report of the last kernel called while profiling is enabled
+struct ProfileState {
+  bool enabled = false;
+  std::string kernel;
+  int threads = 0;
+  double seconds = 0;
+  std::vector<ProfileCounters> counters;
+};
+
+inline ProfileState& profile_state() {
+  static ProfileState state;
+  return state;
+}
+
+//Clears the report, so it only describes a kernel of the current call
+inline void profile_clear() {
+  ProfileState& state = profile_state();
+  state.kernel.clear();
+  state.threads = 0;
+  state.seconds = 0;
+  state.counters.clear();
+}
+
+inline double profile_clock() {
+#ifdef _OPENMP
+  return omp_get_wtime();
+#else
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+inline int profile_thread() {
+#ifdef _OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+//Scoped profile of a kernel call. When profiling is disabled every method
+//returns after testing one flag, so kernels can be instrumented per point.
+class KernelProfile {
+
+public:
+
+  KernelProfile(const char* kernel, int threads) : on(profile_state().enabled), start(0) {
+    if (!on) {
+      return;
+    }
+    ProfileState& state = profile_state();
+    state.kernel = kernel;
+    state.threads = threads;
+    state.seconds = 0;
+    state.counters.assign(std::max(threads, 1), ProfileCounters());
+    counters = state.counters.data();
+    start = profile_clock();
+  }
+
+  ~KernelProfile() {
+    if (on) {
+      profile_state().seconds = profile_clock() - start;
+    }
+  }
+
+  //Time to use as the start of the next lap
+  double now() const {
+    return on ? profile_clock() : 0;
+  }
+
+  //Adds the time since from to a phase of the calling thread
+  double lap(ProfilePhase phase, double from) {
+    if (!on) {
+      return 0;
+    }
+    double to = profile_clock();
+    counters[profile_thread()].seconds[phase] += to - from;
+    return to;
+  }
+
+  //Points processed by the calling thread
+  void points(double n) {
+    if (on) {
+      counters[profile_thread()].points += n;
+    }
+  }
+
+  //Bytes of scratch memory held at once by the calling thread
+  void scratch(double bytes) {
+    if (on) {
+      ProfileCounters& c = counters[profile_thread()];
+      c.scratch = std::max(c.scratch, bytes);
+    }
+  }
+
+  KernelProfile(const KernelProfile&) = delete;
+  KernelProfile& operator=(const KernelProfile&) = delete;
+
+private:
+
+  bool on;
+  double start;
+  ProfileCounters* counters = nullptr;
+};
+
+#endif
@@ -0,0 +1,239 @@
+#ifndef CORE_RANGE_IMAGE_H
+#define CORE_RANGE_IMAGE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//Range image of a single scan. Returns are binned on a zenith x azimuth grid
+//of the angular resolution of the scanner, with cells stored by rows of
+//zenith, so the angular neighbors of a cell are found in O(1). The returns of
+//a cell are sorted by range, so the first and last returns are the ends.
+struct RangeImage {
+  double anchor[3] = {0, 0, 0};
+  double resolution[2] = {1, 1};  //Zenith and azimuth resolution in degrees
+  double frame[4] = {0, 180, 0, 360}; //Min and max zenith and azimuth
+  int64_t rows = 0;               //Cells along the zenith
+  int64_t cols = 0;               //Cells along the azimuth
+  bool wrap = false;              //Azimuth covers 360 degrees
+
+  std::vector<int64_t> cell;      //Cell of each point, -1 outside the frame
+  std::vector<double> range;      //Distance of each point to the anchor
+  std::vector<int64_t> start;     //Returns of cell c are order[start[c]] to order[start[c + 1] - 1]
+  std::vector<int> order;
+
+  int64_t ncells() const {
+    return rows*cols;
+  }
+
+  //Cell at an offset of a cell, or -1 outside the frame
+  inline int64_t offset(int64_t c, int64_t drow, int64_t dcol) const {
+    int64_t r = c / cols + drow;
+    int64_t k = c % cols + dcol;
+    if (r < 0 || r >= rows) {
+      return -1;
+    }
+    if (k < 0 || k >= cols) {
+      if (!wrap) {
+        return -1;
+      }
+      k = ((k % cols) + cols) % cols;
+    }
+    return r*cols + k;
+  }
+
+  double zenith(int64_t c) const {
+    return frame[0] + (c / cols)*resolution[0] + resolution[0]/2;
+  }
+
+  double azimuth(int64_t c) const {
+    return frame[2] + (c % cols)*resolution[1] + resolution[1]/2;
+  }
+};
+
+//Largest number of cells of a range image
+static const int64_t RANGE_IMAGE_MAX_CELLS = (int64_t) 1 << 31;
+
+//Zenith and azimuth (0 to 360) in degrees of a point from the anchor, as in cartesian_to_polar
+inline void range_image_angles(double dx, double dy, double dz, double distance, double& zenith, double& azimuth) {
+  zenith = std::acos(dz/distance)*57.29577951308232;
+  azimuth = std::atan2(dy, dx)*57.29577951308232;
+  if (azimuth < 0) {
+    azimuth += 360;
+  }
+}
+
+//Returns of each cell sorted by range, using a counting sort of the cells
+inline void range_image_index(RangeImage& image) {
+
+  int64_t ncells = image.ncells();
+  int npoints = image.cell.size();
+
+  image.start.assign(ncells + 1, 0);
+
+  for (int i = 0; i < npoints; i++) {
+    if (image.cell[i] >= 0) {
+      image.start[image.cell[i] + 1]++;
+    }
+  }
+
+  for (int64_t c = 0; c < ncells; c++) {
+    image.start[c + 1] += image.start[c];
+  }
+
+  image.order.resize(image.start[ncells]);
+  std::vector<int64_t> next(image.start.begin(), image.start.end() - 1);
+
+  for (int i = 0; i < npoints; i++) {
+    if (image.cell[i] >= 0) {
+      image.order[next[image.cell[i]]++] = i;
+    }
+  }
+
+#pragma omp parallel for schedule(dynamic, 1024)
+  for (int64_t c = 0; c < ncells; c++) {
+    if (image.start[c + 1] - image.start[c] > 1) {
+      std::sort(image.order.begin() + image.start[c], image.order.begin() + image.start[c + 1], [&](int a, int b) {
+        return image.range[a] < image.range[b] || (image.range[a] == image.range[b] && a < b);
+      });
+    }
+  }
+}
+
+//Cells of the points and ranges. Returns false if the resolution gives too
+//many cells for the frame.
+inline bool range_image_cells(const double* X, const double* Y, const double* Z, int npoints, const double* anchor,
+                              const double* resolution, const double* frame, RangeImage& image) {
+
+  for (int a = 0; a < 3; a++) {
+    image.anchor[a] = anchor[a];
+  }
+  for (int a = 0; a < 4; a++) {
+    image.frame[a] = frame[a];
+  }
+  image.resolution[0] = resolution[0];
+  image.resolution[1] = resolution[1];
+
+  double rows = std::max(std::ceil((frame[1] - frame[0])/resolution[0] - 1e-9), 1.0);
+  double cols = std::max(std::ceil((frame[3] - frame[2])/resolution[1] - 1e-9), 1.0);
+
+  if (rows*cols >= (double) RANGE_IMAGE_MAX_CELLS) {
+    return false;
+  }
+
+  image.rows = rows;
+  image.cols = cols;
+  image.wrap = frame[3] - frame[2] >= 360 - 1e-9;
+
+  image.cell.resize(npoints);
+  image.range.resize(npoints);
+
+#pragma omp parallel for
+  for (int i = 0; i < npoints; i++) {
+
+    double dx = X[i] - anchor[0];
+    double dy = Y[i] - anchor[1];
+    double dz = Z[i] - anchor[2];
+    double distance = std::sqrt(dx*dx + dy*dy + dz*dz);
+
+    image.range[i] = distance;
+    image.cell[i] = -1;
+
+    if (distance == 0) {
+      continue;
+    }
+
+    double zenith, azimuth;
+    range_image_angles(dx, dy, dz, distance, zenith, azimuth);
+
+    //Azimuths of a frame starting above 0 may continue after 360
+    if (azimuth < frame[2]) {
+      azimuth += 360;
+    }
+
+    if (zenith < frame[0] || zenith > frame[1] || azimuth > frame[3]) {
+      continue;
+    }
+
+    int64_t r = std::min((int64_t) std::floor((zenith - frame[0])/resolution[0]), image.rows - 1);
+    int64_t k = std::min((int64_t) std::floor((azimuth - frame[2])/resolution[1]), image.cols - 1);
+
+    image.cell[i] = r*image.cols + k;
+  }
+
+  range_image_index(image);
+
+  return true;
+}
+
+//Points with at least min_neighbours other returns within radius on the
+//cells of a window of (2*window + 1) x (2*window + 1) cells around their cell
+//are set to 1 in keep. Points outside the frame are set to 0.
+inline void range_image_neighbors(const RangeImage& image, const double* X, const double* Y, const double* Z,
+                                  double radius, int min_neighbours, int window, std::vector<char>& keep) {
+
+  int npoints = image.cell.size();
+  double r2 = radius*radius;
+
+  keep.assign(npoints, 0);
+
+  //A wrapped window wider than the image visits each column once
+  int64_t last_dk = window;
+  if (image.wrap && 2*(int64_t) window + 1 > image.cols) {
+    last_dk = image.cols - 1 - window;
+  }
+
+#pragma omp parallel for schedule(dynamic, 256)
+  for (int i = 0; i < npoints; i++) {
+
+    int64_t c = image.cell[i];
+
+    if (c < 0) {
+      continue;
+    }
+
+    if (min_neighbours <= 0) {
+      keep[i] = 1;
+      continue;
+    }
+
+    int count = 0;
+
+    for (int64_t dr = -window; dr <= window && count < min_neighbours; dr++) {
+      for (int64_t dk = -window; dk <= last_dk && count < min_neighbours; dk++) {
+
+        int64_t n = image.offset(c, dr, dk);
+        if (n < 0) {
+          continue;
+        }
+
+        //Returns of the cell are sorted by range, so only a band of ranges is compared
+        std::vector<int>::const_iterator from = std::lower_bound(image.order.begin() + image.start[n], image.order.begin() + image.start[n + 1],
+                                                                 image.range[i] - radius, [&](int a, double value) {
+                                                                   return image.range[a] < value;
+                                                                 });
+
+        for (std::vector<int>::const_iterator it = from; it != image.order.begin() + image.start[n + 1]; ++it) {
+          int j = *it;
+          if (image.range[j] > image.range[i] + radius) {
+            break;
+          }
+          if (j == i) {
+            continue;
+          }
+          double ex = X[j] - X[i];
+          double ey = Y[j] - Y[i];
+          double ez = Z[j] - Z[i];
+          if (ex*ex + ey*ey + ez*ez <= r2 && ++count >= min_neighbours) {
+            break;
+          }
+        }
+      }
+    }
+
+    keep[i] = count >= min_neighbours;
+  }
+}
+
+#endif
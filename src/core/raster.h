@@ -0,0 +1,384 @@
+#ifndef CORE_RASTER_H
+#define CORE_RASTER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//Square cells on XY from the minimum XY of the cloud, as the voxels.
+//Cells are stored by rows, so cell = iy*nx + ix.
+struct RasterGrid {
+  double origin[2] = {0, 0};
+  double resolution = 1;
+  int64_t nx = 0;
+  int64_t ny = 0;
+
+  int64_t ncells() const {
+    return nx*ny;
+  }
+
+  double center_x(int64_t cell) const {
+    return origin[0] + (cell % nx)*resolution + resolution/2;
+  }
+
+  double center_y(int64_t cell) const {
+    return origin[1] + (cell / nx)*resolution + resolution/2;
+  }
+};
+
+//Largest number of cells of a raster
+static const int64_t RASTER_MAX_CELLS = (int64_t) 1 << 30;
+
+//Returns false if the resolution gives too many cells for the extent of the cloud
+inline bool raster_grid(const double* X, const double* Y, int npoints, double resolution, RasterGrid& grid) {
+
+  double min[2] = {X[0], Y[0]};
+  double max[2] = {X[0], Y[0]};
+
+  for (int i = 1; i < npoints; i++) {
+    min[0] = std::min(min[0], X[i]); max[0] = std::max(max[0], X[i]);
+    min[1] = std::min(min[1], Y[i]); max[1] = std::max(max[1], Y[i]);
+  }
+
+  double nx = std::floor((max[0] - min[0])/resolution) + 1;
+  double ny = std::floor((max[1] - min[1])/resolution) + 1;
+
+  if (nx*ny > (double) RASTER_MAX_CELLS) {
+    return false;
+  }
+
+  grid.origin[0] = min[0];
+  grid.origin[1] = min[1];
+  grid.resolution = resolution;
+  grid.nx = nx;
+  grid.ny = ny;
+
+  return true;
+}
+
+//Points sorted by cell using a parallel counting sort. The points of a
+//cell are order[start[cell]] to order[start[cell + 1] - 1].
+inline void raster_bin(const RasterGrid& grid, const double* X, const double* Y, int npoints,
+                       std::vector<int64_t>& start, std::vector<int>& order) {
+
+  int64_t ncells = grid.ncells();
+
+  std::vector<int64_t> cell(npoints);
+
+#pragma omp parallel for
+  for (int i = 0; i < npoints; i++) {
+    int64_t ix = std::min((int64_t) std::floor((X[i] - grid.origin[0])/grid.resolution), grid.nx - 1);
+    int64_t iy = std::min((int64_t) std::floor((Y[i] - grid.origin[1])/grid.resolution), grid.ny - 1);
+    cell[i] = iy*grid.nx + ix;
+  }
+
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+
+  //Fewer histograms of cells when there are many cells
+  if ((double) ncells*nthreads > 4.0*npoints + 1e6) {
+    nthreads = std::max(1, (int) ((4.0*npoints + 1e6)/ncells));
+  }
+
+  std::vector<int64_t> counts((size_t) ncells*nthreads, 0);
+
+#pragma omp parallel for schedule(static, 1) num_threads(nthreads)
+  for (int t = 0; t < nthreads; t++) {
+    int from = (int64_t) npoints*t/nthreads;
+    int to = (int64_t) npoints*(t + 1)/nthreads;
+    int64_t* count = &counts[(size_t) ncells*t];
+    for (int i = from; i < to; i++) {
+      count[cell[i]]++;
+    }
+  }
+
+  //Offsets by cell, then by thread to keep the order of the points
+  start.assign(ncells + 1, 0);
+  int64_t offset = 0;
+
+  for (int64_t c = 0; c < ncells; c++) {
+    start[c] = offset;
+    for (int t = 0; t < nthreads; t++) {
+      int64_t n = counts[(size_t) ncells*t + c];
+      counts[(size_t) ncells*t + c] = offset;
+      offset += n;
+    }
+  }
+  start[ncells] = offset;
+
+  order.resize(npoints);
+
+#pragma omp parallel for schedule(static, 1) num_threads(nthreads)
+  for (int t = 0; t < nthreads; t++) {
+    int from = (int64_t) npoints*t/nthreads;
+    int to = (int64_t) npoints*(t + 1)/nthreads;
+    int64_t* next = &counts[(size_t) ncells*t];
+    for (int i = from; i < to; i++) {
+      order[next[cell[i]]++] = i;
+    }
+  }
+}
+
+//Percentile of values between first and last as type 7 of quantile() in R.
+//The values are partially reordered.
+inline double raster_percentile(double* first, double* last, double prob) {
+
+  int64_t n = last - first;
+  double h = (n - 1)*prob;
+  int64_t lo = (int64_t) std::floor(h);
+
+  std::nth_element(first, first + lo, last);
+  double value = first[lo];
+
+  if (lo + 1 < n && h > lo) {
+    double next = *std::min_element(first + lo + 1, last);
+    value += (h - lo)*(next - value);
+  }
+
+  return value;
+}
+
+//Metrics of each cell by layers: min, max, count and the percentiles of probs.
+//Empty cells have a count of 0 and NaN on the remaining metrics. If lowest is
+//not null, it receives the index of the lowest point of each cell, or -1.
+inline void raster_metrics(const RasterGrid& grid, const double* X, const double* Y, const double* Z, int npoints,
+                           const std::vector<double>& probs, std::vector<double>& metrics, std::vector<int>* lowest = nullptr) {
+
+  int64_t ncells = grid.ncells();
+  int nprobs = probs.size();
+  double nan = std::numeric_limits<double>::quiet_NaN();
+
+  std::vector<int64_t> start;
+  std::vector<int> order;
+  raster_bin(grid, X, Y, npoints, start, order);
+
+  metrics.assign((size_t) ncells*(3 + nprobs), nan);
+
+  if (lowest != nullptr) {
+    lowest->assign(ncells, -1);
+  }
+
+#pragma omp parallel
+{
+  std::vector<double> values;
+
+#pragma omp for schedule(dynamic, 1024)
+  for (int64_t c = 0; c < ncells; c++) {
+
+    int64_t from = start[c];
+    int64_t to = start[c + 1];
+
+    metrics[(size_t) ncells*2 + c] = to - from;
+
+    if (to == from) {
+      continue;
+    }
+
+    int low = order[from];
+    double high = Z[order[from]];
+
+    for (int64_t s = from + 1; s < to; s++) {
+      int i = order[s];
+      if (Z[i] < Z[low]) {
+        low = i;
+      }
+      high = std::max(high, Z[i]);
+    }
+
+    metrics[c] = Z[low];
+    metrics[(size_t) ncells + c] = high;
+
+    if (lowest != nullptr) {
+      (*lowest)[c] = low;
+    }
+
+    if (nprobs > 0) {
+      values.resize(to - from);
+      for (int64_t s = from; s < to; s++) {
+        values[s - from] = Z[order[s]];
+      }
+      for (int p = 0; p < nprobs; p++) {
+        metrics[(size_t) ncells*(3 + p) + c] = raster_percentile(values.data(), values.data() + values.size(), probs[p]);
+      }
+    }
+  }
+}
+}
+
+//Fills the NaN cells of a layer by inverse distance weighting of the closest
+//filled cells. The ring of cells where the first filled cell is found and the
+//next ring are used, so the weights do not depend on the direction of search.
+inline void raster_fill(const RasterGrid& grid, double* layer) {
+
+  int64_t ncells = grid.ncells();
+  int64_t max_ring = std::max(grid.nx, grid.ny);
+
+  std::vector<int64_t> empty;
+  for (int64_t c = 0; c < ncells; c++) {
+    if (std::isnan(layer[c])) {
+      empty.push_back(c);
+    }
+  }
+
+  if ((int64_t) empty.size() == ncells) {
+    return;
+  }
+
+  std::vector<double> filled(empty.size());
+  int64_t nempty = empty.size();
+
+#pragma omp parallel for schedule(dynamic, 64)
+  for (int64_t e = 0; e < nempty; e++) {
+
+    int64_t cx = empty[e] % grid.nx;
+    int64_t cy = empty[e] / grid.nx;
+
+    double total = 0;
+    double weights = 0;
+    int64_t last_ring = max_ring;
+
+    for (int64_t r = 1; r <= last_ring; r++) {
+
+      for (int64_t dy = -r; dy <= r; dy++) {
+
+        int64_t y = cy + dy;
+        if (y < 0 || y >= grid.ny) {
+          continue;
+        }
+
+        //Only the border of the ring
+        int64_t step = (dy == -r || dy == r) ? 1 : 2*r;
+
+        for (int64_t dx = -r; dx <= r; dx += step) {
+
+          int64_t x = cx + dx;
+          if (x < 0 || x >= grid.nx) {
+            continue;
+          }
+
+          double value = layer[y*grid.nx + x];
+          if (std::isnan(value)) {
+            continue;
+          }
+
+          double w = 1.0/(double) (dx*dx + dy*dy);
+          total += w*value;
+          weights += w;
+        }
+      }
+
+      if (weights > 0 && last_ring == max_ring) {
+        last_ring = std::min(r + 1, max_ring);
+      }
+    }
+
+    filled[e] = total/weights;
+  }
+
+  for (int64_t e = 0; e < nempty; e++) {
+    layer[empty[e]] = filled[e];
+  }
+}
+
+//Bilinear interpolation of a filled layer between the centers of the cells
+inline double raster_interpolate(const RasterGrid& grid, const double* layer, double x, double y) {
+
+  double fx = (x - grid.origin[0])/grid.resolution - 0.5;
+  double fy = (y - grid.origin[1])/grid.resolution - 0.5;
+
+  int64_t ix = std::max((int64_t) 0, std::min((int64_t) std::floor(fx), grid.nx - 2));
+  int64_t iy = std::max((int64_t) 0, std::min((int64_t) std::floor(fy), grid.ny - 2));
+
+  //Linear beyond the centers of the cells on the border of the raster
+  double tx = (grid.nx > 1) ? fx - ix : 0;
+  double ty = (grid.ny > 1) ? fy - iy : 0;
+
+  int64_t x1 = std::min(ix + 1, grid.nx - 1);
+  int64_t y1 = std::min(iy + 1, grid.ny - 1);
+
+  double z00 = layer[iy*grid.nx + ix];
+  double z10 = layer[iy*grid.nx + x1];
+  double z01 = layer[y1*grid.nx + ix];
+  double z11 = layer[y1*grid.nx + x1];
+
+  return (1 - ty)*((1 - tx)*z00 + tx*z10) + ty*((1 - tx)*z01 + tx*z11);
+}
+
+//Ground at the center of each cell from a plane fitted to the lowest points
+//of the cell and its adjacent cells, which follows slopes without the bias of
+//taking the lowest point of a cell as its center. Empty cells are filled.
+inline void raster_ground(const RasterGrid& grid, const double* X, const double* Y, const double* Z, int npoints, std::vector<double>& ground) {
+
+  int64_t ncells = grid.ncells();
+
+  std::vector<double> metrics;
+  std::vector<int> lowest;
+  raster_metrics(grid, X, Y, Z, npoints, std::vector<double>(), metrics, &lowest);
+
+  ground.assign(ncells, std::numeric_limits<double>::quiet_NaN());
+
+#pragma omp parallel for schedule(dynamic, 1024)
+  for (int64_t c = 0; c < ncells; c++) {
+
+    if (lowest[c] < 0) {
+      continue;
+    }
+
+    int64_t cx = c % grid.nx;
+    int64_t cy = c / grid.nx;
+    double x0 = grid.center_x(c);
+    double y0 = grid.center_y(c);
+
+    //Normal equations of z = a + b*(x - x0) + c*(y - y0)
+    double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0, syy = 0, sz = 0, sxz = 0, syz = 0;
+
+    for (int64_t y = std::max(cy - 1, (int64_t) 0); y <= std::min(cy + 1, grid.ny - 1); y++) {
+      for (int64_t x = std::max(cx - 1, (int64_t) 0); x <= std::min(cx + 1, grid.nx - 1); x++) {
+        int i = lowest[y*grid.nx + x];
+        if (i < 0) {
+          continue;
+        }
+        double ex = X[i] - x0;
+        double ey = Y[i] - y0;
+        n++; sx += ex; sy += ey; sz += Z[i];
+        sxx += ex*ex; sxy += ex*ey; syy += ey*ey;
+        sxz += ex*Z[i]; syz += ey*Z[i];
+      }
+    }
+
+    double det = n*(sxx*syy - sxy*sxy) - sx*(sx*syy - sxy*sy) + sy*(sx*sxy - sxx*sy);
+    double scale = n*sxx*syy;
+
+    //Points on a line or a single point use the lowest point of the cell
+    if (n < 3 || !(std::fabs(det) > 1e-9*scale)) {
+      ground[c] = Z[lowest[c]];
+      continue;
+    }
+
+    ground[c] = (sz*(sxx*syy - sxy*sxy) - sx*(sxz*syy - sxy*syz) + sy*(sxz*sxy - sxx*syz))/det;
+  }
+
+  raster_fill(grid, ground.data());
+}
+
+//Heights of the points above the ground interpolated between the centers of the cells
+inline void raster_normalize(const RasterGrid& grid, const double* X, const double* Y, const double* Z, int npoints, double* heights) {
+
+  std::vector<double> ground;
+  raster_ground(grid, X, Y, Z, npoints, ground);
+
+#pragma omp parallel for
+  for (int i = 0; i < npoints; i++) {
+    heights[i] = Z[i] - raster_interpolate(grid, ground.data(), X[i], Y[i]);
+  }
+}
+
+#endif
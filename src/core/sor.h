@@ -0,0 +1,62 @@
+#ifndef CORE_SOR_H
+#define CORE_SOR_H
+
+#include <cmath>
+#include <vector>
+#include "spatial_grid.h"
+
+//Statistical outlier removal. Points with a mean distance to their k nearest
+//neighbors above the mean + nSigma*sd of all the points are set to 0 in keep.
+//Points are visited in the order of the grid, so neighbors stay in cache.
+inline void sor_filter(const SpatialGrid& grid, int k, double nSigma, std::vector<char>& keep) {
+
+  int npoints = grid.n;
+
+  //Mean distance to the k neighbors of each point
+  std::vector<double> mean_distance(npoints);
+
+#pragma omp parallel
+{
+  std::vector<int> idx(k);
+  std::vector<double> d2(k);
+
+#pragma omp for schedule(dynamic, 256)
+  for (int s = 0; s < npoints; s++) {
+
+    int i = grid.id[s];
+    int found = grid.knn(grid.xyz[3*(size_t) s], grid.xyz[3*(size_t) s + 1], grid.xyz[3*(size_t) s + 2], k, i, idx.data(), d2.data());
+
+    double total = 0;
+    for (int j = 0; j < found; j++) {
+      total += std::sqrt(d2[j]);
+    }
+    mean_distance[i] = total/found;
+  }
+}
+
+  //Mean and sd of the mean distances
+  double total = 0;
+
+#pragma omp parallel for reduction(+:total)
+  for (int i = 0; i < npoints; i++) {
+    total += mean_distance[i];
+  }
+
+  double mean = total/npoints;
+  double squares = 0;
+
+#pragma omp parallel for reduction(+:squares)
+  for (int i = 0; i < npoints; i++) {
+    squares += (mean_distance[i] - mean)*(mean_distance[i] - mean);
+  }
+
+  double max_distance = mean + std::sqrt(squares/(npoints - 1))*nSigma;
+
+  keep.resize(npoints);
+
+  for (int i = 0; i < npoints; i++) {
+    keep[i] = mean_distance[i] <= max_distance;
+  }
+}
+
+#endif
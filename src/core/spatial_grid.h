@@ -0,0 +1,480 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+//Uniform grid over the occupied cells of a point cloud.
+//Points are stored sorted by cell so each cell is a contiguous range,
+//and cells are sorted by key so a row of cells along X is also contiguous.
+class SpatialGrid {
+
+public:
+
+  int n = 0;                    //Number of points
+  double cell = 0;              //Edge length of the cells
+  double origin[3] = {0, 0, 0}; //Minimum XYZ of the cloud
+  int64_t dims[3] = {1, 1, 1};  //Number of cells per axis
+
+  std::vector<double> xyz;      //Sorted coordinates, interleaved XYZ
+  std::vector<int> id;          //Original index of the sorted points
+  std::vector<uint64_t> keys;   //Sorted keys of the occupied cells
+  std::vector<int> start;       //Offsets of each occupied cell in xyz
+  std::vector<int> slabs[3];    //Cumulative number of points per slab of cells on each axis
+
+  SpatialGrid() {}
+
+  //If cell_size <= 0 the cell is estimated to hold a few points on average
+  SpatialGrid(const double* X, const double* Y, const double* Z, int npoints, double cell_size = 0) {
+    build(X, Y, Z, npoints, cell_size);
+  }
+
+  void build(const double* X, const double* Y, const double* Z, int npoints, double cell_size = 0) {
+
+    n = npoints;
+
+    //An empty grid of a single cell, so searches on it find nothing
+    if (n <= 0) {
+      n = 0;
+      cell = cell_size > 0 ? cell_size : 1;
+      for (int a = 0; a < 3; a++) {
+        origin[a] = 0;
+        dims[a] = 1;
+        slabs[a].assign(2, 0);
+      }
+      xyz.clear();
+      id.clear();
+      keys.clear();
+      start.assign(1, 0);
+      return;
+    }
+
+    double lo[3] = {X[0], Y[0], Z[0]};
+    double hi[3] = {X[0], Y[0], Z[0]};
+
+    for (int i = 1; i < n; i++) {
+      lo[0] = std::min(lo[0], X[i]); hi[0] = std::max(hi[0], X[i]);
+      lo[1] = std::min(lo[1], Y[i]); hi[1] = std::max(hi[1], Y[i]);
+      lo[2] = std::min(lo[2], Z[i]); hi[2] = std::max(hi[2], Z[i]);
+    }
+
+    double extent = std::max(hi[0] - lo[0], std::max(hi[1] - lo[1], hi[2] - lo[2]));
+    double min_cell = std::max(extent/2097152.0, 1e-12); //Keep dims below 2^21 per axis
+
+    bool adapt = cell_size <= 0;
+
+    if (adapt) {
+      double volume = std::max(hi[0] - lo[0], min_cell)*std::max(hi[1] - lo[1], min_cell)*std::max(hi[2] - lo[2], min_cell);
+      cell_size = std::cbrt(volume*4/n);
+    }
+
+    for (int a = 0; a < 3; a++) {
+      origin[a] = lo[a];
+    }
+
+    std::vector<uint64_t> point_key(n);
+
+    //Clouds from TLS are mostly surfaces, so refine the cell once with the occupancy
+    for (int pass = 0; pass < (adapt ? 2 : 1); pass++) {
+
+      cell = std::max(cell_size, min_cell);
+
+      for (int a = 0; a < 3; a++) {
+        dims[a] = (int64_t) std::floor((hi[a] - lo[a])/cell) + 1;
+      }
+
+#pragma omp parallel for
+      for (int i = 0; i < n; i++) {
+        point_key[i] = key(cell_of(X[i], 0), cell_of(Y[i], 1), cell_of(Z[i], 2));
+      }
+
+      id.resize(n);
+      for (int i = 0; i < n; i++) {
+        id[i] = i;
+      }
+
+      std::sort(id.begin(), id.end(), [&](int a, int b) {
+        return point_key[a] < point_key[b] || (point_key[a] == point_key[b] && a < b);
+      });
+
+      int occupied = 0;
+      for (int s = 0; s < n; s++) {
+        if (s == 0 || point_key[id[s]] != point_key[id[s - 1]]) {
+          occupied++;
+        }
+      }
+
+      double occupancy = (double) n/occupied;
+
+      if (!adapt || pass == 1 || (occupancy > 2 && occupancy < 8)) {
+        break;
+      }
+
+      cell_size = cell*std::sqrt(4/occupancy);
+    }
+
+    keys.clear();
+    start.clear();
+    xyz.resize(3*(size_t) n);
+
+    for (int a = 0; a < 3; a++) {
+      slabs[a].assign(dims[a] + 1, 0);
+    }
+
+    for (int s = 0; s < n; s++) {
+      int i = id[s];
+      if (s == 0 || point_key[i] != point_key[id[s - 1]]) {
+        keys.push_back(point_key[i]);
+        start.push_back(s);
+      }
+      xyz[3*(size_t) s] = X[i];
+      xyz[3*(size_t) s + 1] = Y[i];
+      xyz[3*(size_t) s + 2] = Z[i];
+      slabs[0][cell_of(X[i], 0) + 1]++;
+      slabs[1][cell_of(Y[i], 1) + 1]++;
+      slabs[2][cell_of(Z[i], 2) + 1]++;
+    }
+    start.push_back(n);
+
+    for (int a = 0; a < 3; a++) {
+      for (int64_t j = 0; j < dims[a]; j++) {
+        slabs[a][j + 1] += slabs[a][j];
+      }
+    }
+  }
+
+  inline int64_t cell_of(double v, int a) const {
+    return (int64_t) std::floor((v - origin[a])/cell);
+  }
+
+  inline uint64_t key(int64_t cx, int64_t cy, int64_t cz) const {
+    return (uint64_t) cx + (uint64_t) dims[0]*((uint64_t) cy + (uint64_t) dims[1]*(uint64_t) cz);
+  }
+
+  //Range of sorted points in cells [x0, x1] of a given row
+  inline void row(int64_t x0, int64_t x1, int64_t cy, int64_t cz, int& from, int& to) const {
+    x0 = std::max(x0, (int64_t) 0);
+    x1 = std::min(x1, dims[0] - 1);
+    if (x0 > x1 || cy < 0 || cy >= dims[1] || cz < 0 || cz >= dims[2] ||
+        slabs[0][x1 + 1] == slabs[0][x0] || slabs[1][cy + 1] == slabs[1][cy] || slabs[2][cz + 1] == slabs[2][cz]) {
+      from = to = 0;
+      return;
+    }
+    size_t a = std::lower_bound(keys.begin(), keys.end(), key(x0, cy, cz)) - keys.begin();
+    size_t b = std::upper_bound(keys.begin() + a, keys.end(), key(x1, cy, cz)) - keys.begin();
+    from = start[a];
+    to = start[b];
+  }
+
+  //k nearest neighbors of a point, skipping the point with index exclude.
+  //Returns the number of neighbors found, sorted by squared distance in d2.
+  //Points farther than max_distance are not neighbors, so the search stops at
+  //the rings beyond it.
+  int knn(double qx, double qy, double qz, int k, int exclude, int* idx, double* d2,
+          double max_distance = INFINITY) const {
+
+    int64_t c[3] = {cell_of(qx, 0), cell_of(qy, 1), cell_of(qz, 2)};
+    double q[3] = {qx, qy, qz};
+    double max2 = max_distance*max_distance;
+    int found = 0;
+
+    //Rings before min_ring do not reach the grid when the query is outside
+    int64_t min_ring = 0;
+    int64_t max_ring = 0;
+    for (int a = 0; a < 3; a++) {
+      min_ring = std::max(min_ring, std::max(-c[a], c[a] - dims[a] + 1));
+      max_ring = std::max(max_ring, std::max(std::abs(c[a]), std::abs(dims[a] - 1 - c[a])));
+    }
+
+    for (int64_t r = min_ring; r <= max_ring; r++) {
+
+      //Cells of the ring are at least r - 1 cells away from the query
+      if ((r - 1)*cell > max_distance) {
+        break;
+      }
+
+      //Rings are clipped to the grid so far queries do not visit empty rows
+      for (int64_t dz = std::max(-r, -c[2]); dz <= std::min(r, dims[2] - 1 - c[2]); dz++) {
+        for (int64_t dy = std::max(-r, -c[1]); dy <= std::min(r, dims[1] - 1 - c[1]); dy++) {
+
+          //Full rows on the faces of the ring, only both ends inside
+          bool face = (dz == -r || dz == r || dy == -r || dy == r);
+
+          for (int side = 0; side < (face ? 1 : 2); side++) {
+
+            int from, to;
+            if (face) {
+              row(c[0] - r, c[0] + r, c[1] + dy, c[2] + dz, from, to);
+            } else {
+              int64_t cx = (side == 0) ? c[0] - r : c[0] + r;
+              row(cx, cx, c[1] + dy, c[2] + dz, from, to);
+            }
+
+            for (int s = from; s < to; s++) {
+
+              if (id[s] == exclude) {
+                continue;
+              }
+
+              double ex = xyz[3*(size_t) s] - qx;
+              double ey = xyz[3*(size_t) s + 1] - qy;
+              double ez = xyz[3*(size_t) s + 2] - qz;
+              double dist = ex*ex + ey*ey + ez*ez;
+
+              if (dist > max2 || (found == k && dist >= d2[k - 1])) {
+                continue;
+              }
+
+              //Insertion on the sorted candidates
+              int pos = (found < k) ? found++ : k - 1;
+              while (pos > 0 && (d2[pos - 1] > dist || (d2[pos - 1] == dist && idx[pos - 1] > id[s]))) {
+                d2[pos] = d2[pos - 1];
+                idx[pos] = idx[pos - 1];
+                pos--;
+              }
+              d2[pos] = dist;
+              idx[pos] = id[s];
+            }
+          }
+        }
+      }
+
+      //Distance from the query to the border of the searched cells
+      double bound = INFINITY;
+      for (int a = 0; a < 3; a++) {
+        double low = q[a] - (origin[a] + (c[a] - r)*cell);
+        double high = (origin[a] + (c[a] + r + 1)*cell) - q[a];
+        bound = std::min(bound, std::min(low, high));
+      }
+
+      if ((found == k && d2[k - 1] <= bound*bound) || bound >= max_distance) {
+        break;
+      }
+    }
+
+    return found;
+  }
+
+  //Number of points within a radius, skipping exclude and stopping at limit
+  int radius_count(double qx, double qy, double qz, double radius, int exclude, int limit) const {
+
+    int64_t c[3] = {cell_of(qx, 0), cell_of(qy, 1), cell_of(qz, 2)};
+    int64_t reach = (int64_t) std::ceil(radius/cell);
+    double r2 = radius*radius;
+    int count = 0;
+
+    //Clipped to the grid as in knn, so large radius or far queries do not visit empty rows
+    for (int64_t dz = std::max(-reach, -c[2]); dz <= std::min(reach, dims[2] - 1 - c[2]); dz++) {
+      for (int64_t dy = std::max(-reach, -c[1]); dy <= std::min(reach, dims[1] - 1 - c[1]); dy++) {
+
+        int from, to;
+        row(c[0] - reach, c[0] + reach, c[1] + dy, c[2] + dz, from, to);
+
+        for (int s = from; s < to; s++) {
+
+          double ex = xyz[3*(size_t) s] - qx;
+          double ey = xyz[3*(size_t) s + 1] - qy;
+          double ez = xyz[3*(size_t) s + 2] - qz;
+
+          if (ex*ex + ey*ey + ez*ez <= r2 && id[s] != exclude) {
+            count++;
+            if (count >= limit) {
+              return count;
+            }
+          }
+        }
+      }
+    }
+
+    return count;
+  }
+
+  //Indices and squared distances of the points within a radius
+  void radius(double qx, double qy, double qz, double radius, int exclude, std::vector<int>& idx, std::vector<double>& d2) const {
+
+    idx.clear();
+    d2.clear();
+
+    int64_t c[3] = {cell_of(qx, 0), cell_of(qy, 1), cell_of(qz, 2)};
+    int64_t reach = (int64_t) std::ceil(radius/cell);
+    double r2 = radius*radius;
+
+    //Clipped to the grid as in knn, so large radius or far queries do not visit empty rows
+    for (int64_t dz = std::max(-reach, -c[2]); dz <= std::min(reach, dims[2] - 1 - c[2]); dz++) {
+      for (int64_t dy = std::max(-reach, -c[1]); dy <= std::min(reach, dims[1] - 1 - c[1]); dy++) {
+
+        int from, to;
+        row(c[0] - reach, c[0] + reach, c[1] + dy, c[2] + dz, from, to);
+
+        for (int s = from; s < to; s++) {
+
+          double ex = xyz[3*(size_t) s] - qx;
+          double ey = xyz[3*(size_t) s + 1] - qy;
+          double ez = xyz[3*(size_t) s + 2] - qz;
+          double dist = ex*ex + ey*ey + ez*ez;
+
+          if (dist <= r2 && id[s] != exclude) {
+            idx.push_back(id[s]);
+            d2.push_back(dist);
+          }
+        }
+      }
+    }
+  }
+
+  //Binary file with the grid, in the byte order of the machine
+  bool save(const char* file) const {
+
+    std::ofstream out(file, std::ios::binary);
+    if (!out) {
+      return false;
+    }
+
+    uint32_t version = 1;
+    uint64_t nkeys = keys.size();
+
+    out.write("rTLSgrid", 8);
+    out.write((const char*) &version, sizeof(version));
+    out.write((const char*) &n, sizeof(n));
+    out.write((const char*) &cell, sizeof(cell));
+    out.write((const char*) origin, sizeof(origin));
+    out.write((const char*) dims, sizeof(dims));
+    out.write((const char*) &nkeys, sizeof(nkeys));
+    out.write((const char*) xyz.data(), xyz.size()*sizeof(double));
+    out.write((const char*) id.data(), id.size()*sizeof(int));
+    out.write((const char*) keys.data(), keys.size()*sizeof(uint64_t));
+    out.write((const char*) start.data(), start.size()*sizeof(int));
+    for (int a = 0; a < 3; a++) {
+      out.write((const char*) slabs[a].data(), slabs[a].size()*sizeof(int));
+    }
+
+    return (bool) out;
+  }
+
+  bool load(const char* file) {
+
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+      return false;
+    }
+
+    char magic[8];
+    uint32_t version = 0;
+    uint64_t nkeys = 0;
+
+    in.read(magic, 8);
+    in.read((char*) &version, sizeof(version));
+    if (!in || std::memcmp(magic, "rTLSgrid", 8) != 0 || version != 1) {
+      return false;
+    }
+
+    in.read((char*) &n, sizeof(n));
+    in.read((char*) &cell, sizeof(cell));
+    in.read((char*) origin, sizeof(origin));
+    in.read((char*) dims, sizeof(dims));
+    in.read((char*) &nkeys, sizeof(nkeys));
+    if (!in || n < 0 || nkeys > (uint64_t) n) {
+      return false;
+    }
+    for (int a = 0; a < 3; a++) {
+      if (dims[a] < 1 || dims[a] > 2097153) {
+        return false;
+      }
+    }
+
+    xyz.resize(3*(size_t) n);
+    id.resize(n);
+    keys.resize(nkeys);
+    start.resize(nkeys + 1);
+
+    in.read((char*) xyz.data(), xyz.size()*sizeof(double));
+    in.read((char*) id.data(), id.size()*sizeof(int));
+    in.read((char*) keys.data(), keys.size()*sizeof(uint64_t));
+    in.read((char*) start.data(), start.size()*sizeof(int));
+    for (int a = 0; a < 3; a++) {
+      slabs[a].resize(dims[a] + 1);
+      in.read((char*) slabs[a].data(), slabs[a].size()*sizeof(int));
+    }
+
+    return (bool) in && valid();
+  }
+
+  //Checks that the contents describe a grid, so a corrupt file can not give
+  //searches indices out of bounds
+  bool valid() const {
+
+    if (!std::isfinite(cell) || cell <= 0) {
+      return false;
+    }
+    for (int a = 0; a < 3; a++) {
+      if (!std::isfinite(origin[a])) {
+        return false;
+      }
+    }
+
+    //Ids are a permutation of the points
+    std::vector<char> seen(n, 0);
+    for (int s = 0; s < n; s++) {
+      if (id[s] < 0 || id[s] >= n || seen[id[s]]) {
+        return false;
+      }
+      seen[id[s]] = 1;
+    }
+
+    //Occupied cells are sorted and each one holds points
+    int nkeys = keys.size();
+    if (start.empty() || start[0] != 0 || start[nkeys] != n) {
+      return false;
+    }
+    uint64_t ncells = (uint64_t) dims[0]*(uint64_t) dims[1]*(uint64_t) dims[2];
+    for (int c = 0; c < nkeys; c++) {
+      if (keys[c] >= ncells || (c > 0 && keys[c] <= keys[c - 1]) || start[c + 1] <= start[c]) {
+        return false;
+      }
+    }
+
+    //Points lie in their cells, and the slabs count them
+    std::vector<int> counts[3];
+    for (int a = 0; a < 3; a++) {
+      counts[a].assign(dims[a] + 1, 0);
+    }
+
+    for (int c = 0; c < nkeys; c++) {
+      for (int s = start[c]; s < start[c + 1]; s++) {
+        int64_t cx[3];
+        for (int a = 0; a < 3; a++) {
+          double v = xyz[3*(size_t) s + a];
+          if (!std::isfinite(v)) {
+            return false;
+          }
+          cx[a] = cell_of(v, a);
+          if (cx[a] < 0 || cx[a] >= dims[a]) {
+            return false;
+          }
+          counts[a][cx[a] + 1]++;
+        }
+        if (key(cx[0], cx[1], cx[2]) != keys[c]) {
+          return false;
+        }
+      }
+    }
+
+    for (int a = 0; a < 3; a++) {
+      for (int64_t j = 0; j < dims[a]; j++) {
+        counts[a][j + 1] += counts[a][j];
+      }
+      if (counts[a] != slabs[a]) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+};
+
+#endif
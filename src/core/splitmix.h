@@ -0,0 +1,22 @@
+#ifndef CORE_SPLITMIX_H
+#define CORE_SPLITMIX_H
+
+#include <cstdint>
+
+//splitmix64 generator. Parallel loops seed one stream per iteration from a
+//single seed, so the draws do not depend on the threads.
+struct SplitMix {
+  uint64_t state;
+  explicit SplitMix(uint64_t seed) : state(seed) {}
+  inline uint64_t next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+  inline double uniform() {
+    return (next() >> 11) * 0x1.0p-53;
+  }
+};
+
+#endif
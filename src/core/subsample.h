@@ -0,0 +1,162 @@
+#ifndef CORE_SUBSAMPLE_H
+#define CORE_SUBSAMPLE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "spatial_grid.h"
+#include "voxel_key.h"
+
+//Minimum distance (Poisson-disk) thinning. Points are accepted in the order
+//of the grid if no accepted point is closer than distance, so the selected
+//points are at least distance apart. Cells are coloured so that cells of the
+//same colour are more than distance apart and each colour is a parallel
+//phase; with cells of edge distance this gives 8 colours. The selection does
+//not depend on the number of threads. Returns the sorted original indices.
+inline void poisson_disk(const SpatialGrid& grid, double distance, std::vector<int>& selected) {
+
+  int ncells = grid.keys.size();
+
+  //Cells to search on each side and period of the colours
+  int64_t reach = std::max((int64_t) std::ceil(distance/grid.cell), (int64_t) 1);
+  int64_t period = reach + 1;
+  int64_t ncolours = period*period*period;
+
+  std::vector<int64_t> coords(3*(size_t) ncells);
+  std::vector<int> colour_start(ncolours + 1, 0);
+  std::vector<int> colour_cells(ncells);
+
+  for (int c = 0; c < ncells; c++) {
+    uint64_t key = grid.keys[c];
+    int64_t cx = key % grid.dims[0];
+    int64_t cy = (key / grid.dims[0]) % grid.dims[1];
+    int64_t cz = key / grid.dims[0] / grid.dims[1];
+    coords[3*(size_t) c] = cx;
+    coords[3*(size_t) c + 1] = cy;
+    coords[3*(size_t) c + 2] = cz;
+    colour_start[(cx % period) + period*((cy % period) + period*(cz % period)) + 1]++;
+  }
+
+  for (int64_t p = 0; p < ncolours; p++) {
+    colour_start[p + 1] += colour_start[p];
+  }
+
+  std::vector<int> next(colour_start.begin(), colour_start.end() - 1);
+  for (int c = 0; c < ncells; c++) {
+    int64_t cx = coords[3*(size_t) c];
+    int64_t cy = coords[3*(size_t) c + 1];
+    int64_t cz = coords[3*(size_t) c + 2];
+    colour_cells[next[(cx % period) + period*((cy % period) + period*(cz % period))]++] = c;
+  }
+
+  //Accepted points of each cell, by position in the grid. Dense cells near
+  //the scanner only compare their points with the few accepted neighbors.
+  std::vector<std::vector<int>> accepted(ncells);
+  double d2 = distance*distance;
+
+  for (int64_t p = 0; p < ncolours; p++) {
+
+    //Cells of a colour only read cells of other colours
+#pragma omp parallel
+{
+    std::vector<int> neighbors;
+
+#pragma omp for schedule(dynamic, 64)
+    for (int j = colour_start[p]; j < colour_start[p + 1]; j++) {
+
+      int c = colour_cells[j];
+      int64_t cx = coords[3*(size_t) c];
+      int64_t cy = coords[3*(size_t) c + 1];
+      int64_t cz = coords[3*(size_t) c + 2];
+
+      //Occupied cells around the cell, including itself
+      neighbors.clear();
+      for (int64_t dz = -reach; dz <= reach; dz++) {
+        for (int64_t dy = -reach; dy <= reach; dy++) {
+          int from, to;
+          grid.row(cx - reach, cx + reach, cy + dy, cz + dz, from, to);
+          if (from == to) {
+            continue;
+          }
+          int first = std::upper_bound(grid.start.begin(), grid.start.end(), from) - grid.start.begin() - 1;
+          for (int n = first; grid.start[n] < to; n++) {
+            neighbors.push_back(n);
+          }
+        }
+      }
+
+      for (int s = grid.start[c]; s < grid.start[c + 1]; s++) {
+
+        double qx = grid.xyz[3*(size_t) s];
+        double qy = grid.xyz[3*(size_t) s + 1];
+        double qz = grid.xyz[3*(size_t) s + 2];
+        bool keep = true;
+
+        for (size_t n = 0; n < neighbors.size() && keep; n++) {
+          const std::vector<int>& near = accepted[neighbors[n]];
+          for (size_t r = 0; r < near.size(); r++) {
+            double ex = grid.xyz[3*(size_t) near[r]] - qx;
+            double ey = grid.xyz[3*(size_t) near[r] + 1] - qy;
+            double ez = grid.xyz[3*(size_t) near[r] + 2] - qz;
+            if (ex*ex + ey*ey + ez*ez < d2) {
+              keep = false;
+              break;
+            }
+          }
+        }
+
+        if (keep) {
+          accepted[c].push_back(s);
+        }
+      }
+    }
+}
+  }
+
+  selected.clear();
+  for (int c = 0; c < ncells; c++) {
+    for (size_t r = 0; r < accepted[c].size(); r++) {
+      selected.push_back(grid.id[accepted[c][r]]);
+    }
+  }
+
+  std::sort(selected.begin(), selected.end());
+}
+
+//Random fraction of the points. Each point gets a hash of its index and the
+//seed, and the round(fraction*npoints) points with the lowest hashes are
+//selected, so the sample only depends on the seed and not on the threads.
+//Returns the sorted indices.
+inline void random_fraction(int npoints, double fraction, uint64_t seed, std::vector<int>& selected) {
+
+  int nselected = (int) std::llround(fraction*npoints);
+  nselected = std::max(0, std::min(nselected, npoints));
+
+  std::vector<uint64_t> hash(npoints);
+  uint64_t salt = voxel_hash(seed + 0x9e3779b97f4a7c15ULL);
+
+#pragma omp parallel for
+  for (int i = 0; i < npoints; i++) {
+    hash[i] = voxel_hash(salt ^ ((uint64_t) i*0x9e3779b97f4a7c15ULL));
+  }
+
+  std::vector<int> order(npoints);
+  for (int i = 0; i < npoints; i++) {
+    order[i] = i;
+  }
+
+  //Ties of the hash keep the lowest index
+  auto lower = [&](int a, int b) {
+    return hash[a] < hash[b] || (hash[a] == hash[b] && a < b);
+  };
+
+  if (nselected < npoints) {
+    std::nth_element(order.begin(), order.begin() + nselected, order.end(), lower);
+  }
+
+  selected.assign(order.begin(), order.begin() + nselected);
+  std::sort(selected.begin(), selected.end());
+}
+
+#endif
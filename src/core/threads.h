@@ -0,0 +1,61 @@
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <algorithm>
+#include "profiler.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//Scoped number of threads of a kernel. The number used before the call is
+//restored when the kernel returns, so a call does not change the threads of
+//the R session. Requests are capped to the available cores, and kernels
+//called from a parallel region run on the calling thread to avoid nesting.
+//A new call clears the profile report of the previous one.
+class ThreadGuard {
+
+public:
+
+  explicit ThreadGuard(int threads) {
+    bool nested = false;
+#ifdef _OPENMP
+    nested = omp_in_parallel();
+#endif
+    if (profile_state().enabled && !nested) {
+      profile_clear();
+    }
+#ifdef _OPENMP
+    previous = omp_get_max_threads();
+    int wanted = (threads > 0) ? std::min(threads, omp_get_num_procs()) : previous;
+    if (omp_in_parallel()) {
+      wanted = 1;
+    }
+    omp_set_num_threads(wanted);
+#endif
+  }
+
+  ~ThreadGuard() {
+#ifdef _OPENMP
+    omp_set_num_threads(previous);
+#endif
+  }
+
+  //Number of threads used by the parallel regions of the kernel
+  int threads() const {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+  }
+
+  ThreadGuard(const ThreadGuard&) = delete;
+  ThreadGuard& operator=(const ThreadGuard&) = delete;
+
+private:
+
+  int previous = 1;
+};
+
+#endif
@@ -0,0 +1,246 @@
+#ifndef CORE_VOXEL_COMPONENTS_H
+#define CORE_VOXEL_COMPONENTS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+#include "morton.h"
+
+//Connected components of the occupied voxels of a cloud. Voxels and
+//components are numbered from 0 in order of appearance in the cloud.
+struct VoxelComponents {
+  std::vector<int> voxel;    //Voxel of each point
+  std::vector<int> label;    //Component of each voxel
+  std::vector<double> xyz;   //Centers of the voxels, interleaved XYZ
+  std::vector<int> n;        //Points of each voxel
+  std::vector<int> voxels;   //Voxels of each component
+  std::vector<int> points;   //Points of each component
+  std::vector<double> box;   //Bounding box of the points of each component, min XYZ and max XYZ
+  int ncomponents = 0;
+};
+
+//Lock-free union-find. Roots are linked to the lowest root with a compare and
+//swap, so the root of a component is always its lowest voxel and the labels
+//do not depend on the order of the unions.
+inline int component_find(std::vector<std::atomic<int>>& parent, int v) {
+  int p = parent[v].load(std::memory_order_relaxed);
+  while (p != v) {
+    int gp = parent[p].load(std::memory_order_relaxed);
+    //Path halving, any ancestor is a valid parent
+    parent[v].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+    v = p;
+    p = parent[v].load(std::memory_order_relaxed);
+  }
+  return v;
+}
+
+inline void component_union(std::vector<std::atomic<int>>& parent, int a, int b) {
+  while (true) {
+    a = component_find(parent, a);
+    b = component_find(parent, b);
+    if (a == b) {
+      return;
+    }
+    if (a < b) {
+      std::swap(a, b);
+    }
+    int root = a;
+    if (parent[a].compare_exchange_strong(root, b, std::memory_order_relaxed)) {
+      return;
+    }
+  }
+}
+
+//Voxels sharing a face (6), a face or an edge (18), or a face, an edge or a
+//corner (26) are connected. Returns false if the edge length is too small for
+//the extent of the cloud.
+inline bool voxel_components(const double* X, const double* Y, const double* Z, int npoints, const double* edge_length,
+                             int connectivity, VoxelComponents& out) {
+
+  out = VoxelComponents();
+
+  if (npoints == 0) {
+    return true;
+  }
+
+  double min[3] = {X[0], Y[0], Z[0]};
+  double max[3] = {X[0], Y[0], Z[0]};
+
+  for (int i = 1; i < npoints; i++) {
+    min[0] = std::min(min[0], X[i]); max[0] = std::max(max[0], X[i]);
+    min[1] = std::min(min[1], Y[i]); max[1] = std::max(max[1], Y[i]);
+    min[2] = std::min(min[2], Z[i]); max[2] = std::max(max[2], Z[i]);
+  }
+
+  int64_t dims[3];
+  for (int a = 0; a < 3; a++) {
+    dims[a] = (int64_t) std::floor((max[a] - min[a])/edge_length[a]) + 1;
+    if (dims[a] > MORTON_MAX) {
+      return false;
+    }
+  }
+
+  //Morton code of the voxel of each point
+  std::vector<uint64_t> codes(npoints);
+
+#pragma omp parallel for
+  for (int i = 0; i < npoints; i++) {
+    codes[i] = morton_code((int64_t) std::floor((X[i] - min[0])/edge_length[0]),
+                           (int64_t) std::floor((Y[i] - min[1])/edge_length[1]),
+                           (int64_t) std::floor((Z[i] - min[2])/edge_length[2]));
+  }
+
+  std::vector<int> order;
+  bool sorted = morton_sorted(codes);
+
+  if (!sorted) {
+    morton_sort(codes, order);
+  }
+
+  //Runs of equal codes are the voxels, sorted by code
+  std::vector<uint64_t> run_code;
+  std::vector<int> run_first;
+  std::vector<int> run_start;
+
+  for (int s = 0; s < npoints; s++) {
+    int i = sorted ? s : order[s];
+    if (s == 0 || codes[s] != codes[s - 1]) {
+      run_code.push_back(codes[s]);
+      run_first.push_back(i);
+      run_start.push_back(s);
+    } else {
+      run_first.back() = std::min(run_first.back(), i);
+    }
+  }
+  run_start.push_back(npoints);
+
+  int nvoxels = run_code.size();
+
+  //Voxels in order of appearance in the cloud
+  std::vector<int> rank(nvoxels);
+  for (int r = 0; r < nvoxels; r++) {
+    rank[r] = r;
+  }
+
+  std::sort(rank.begin(), rank.end(), [&](int a, int b) {
+    return run_first[a] < run_first[b];
+  });
+
+  std::vector<int> voxel_of_run(nvoxels);
+  for (int v = 0; v < nvoxels; v++) {
+    voxel_of_run[rank[v]] = v;
+  }
+
+  out.voxel.resize(npoints);
+  out.xyz.resize(3*(size_t) nvoxels);
+  out.n.resize(nvoxels);
+
+#pragma omp parallel for
+  for (int r = 0; r < nvoxels; r++) {
+
+    int v = voxel_of_run[r];
+    int i = run_first[r];
+
+    for (int s = run_start[r]; s < run_start[r + 1]; s++) {
+      out.voxel[sorted ? s : order[s]] = v;
+    }
+
+    out.xyz[3*(size_t) v] = min[0] + std::floor((X[i] - min[0])/edge_length[0])*edge_length[0] + edge_length[0]/2;
+    out.xyz[3*(size_t) v + 1] = min[1] + std::floor((Y[i] - min[1])/edge_length[1])*edge_length[1] + edge_length[1]/2;
+    out.xyz[3*(size_t) v + 2] = min[2] + std::floor((Z[i] - min[2])/edge_length[2])*edge_length[2] + edge_length[2]/2;
+    out.n[v] = run_start[r + 1] - run_start[r];
+  }
+
+  //Half of the neighbors, the other half is reached from the neighbor
+  std::vector<int> offsets;
+  for (int dz = -1; dz <= 1; dz++) {
+    for (int dy = -1; dy <= 1; dy++) {
+      for (int dx = -1; dx <= 1; dx++) {
+        int order_of = std::abs(dx) + std::abs(dy) + std::abs(dz);
+        bool forward = dz > 0 || (dz == 0 && dy > 0) || (dz == 0 && dy == 0 && dx > 0);
+        if (forward && ((connectivity == 6 && order_of == 1) ||
+                        (connectivity == 18 && order_of <= 2) ||
+                        (connectivity == 26))) {
+          offsets.push_back(dx);
+          offsets.push_back(dy);
+          offsets.push_back(dz);
+        }
+      }
+    }
+  }
+
+  int noffsets = offsets.size()/3;
+
+  std::vector<std::atomic<int>> parent(nvoxels);
+  for (int v = 0; v < nvoxels; v++) {
+    parent[v].store(v, std::memory_order_relaxed);
+  }
+
+#pragma omp parallel for schedule(dynamic, 256)
+  for (int r = 0; r < nvoxels; r++) {
+
+    int i = run_first[r];
+    int64_t c[3] = {(int64_t) std::floor((X[i] - min[0])/edge_length[0]),
+                    (int64_t) std::floor((Y[i] - min[1])/edge_length[1]),
+                    (int64_t) std::floor((Z[i] - min[2])/edge_length[2])};
+
+    for (int o = 0; o < noffsets; o++) {
+
+      int64_t q[3] = {c[0] + offsets[3*o], c[1] + offsets[3*o + 1], c[2] + offsets[3*o + 2]};
+
+      if (q[0] < 0 || q[1] < 0 || q[2] < 0 || q[0] >= dims[0] || q[1] >= dims[1] || q[2] >= dims[2]) {
+        continue;
+      }
+
+      //Occupied neighbors are found by their code in the sorted runs
+      uint64_t code = morton_code(q[0], q[1], q[2]);
+      std::vector<uint64_t>::const_iterator it = std::lower_bound(run_code.begin(), run_code.end(), code);
+
+      if (it != run_code.end() && *it == code) {
+        component_union(parent, voxel_of_run[r], voxel_of_run[it - run_code.begin()]);
+      }
+    }
+  }
+
+  //Components in order of their lowest voxel
+  out.label.resize(nvoxels);
+
+  for (int v = 0; v < nvoxels; v++) {
+    int root = component_find(parent, v);
+    if (root == v) {
+      out.label[v] = out.ncomponents++;
+    } else {
+      out.label[v] = out.label[root];
+    }
+  }
+
+  int ncomponents = out.ncomponents;
+
+  out.voxels.assign(ncomponents, 0);
+  out.points.assign(ncomponents, 0);
+  out.box.resize(6*(size_t) ncomponents);
+
+  for (int k = 0; k < ncomponents; k++) {
+    for (int a = 0; a < 3; a++) {
+      out.box[6*(size_t) k + a] = max[a];
+      out.box[6*(size_t) k + 3 + a] = min[a];
+    }
+  }
+
+  for (int v = 0; v < nvoxels; v++) {
+    out.voxels[out.label[v]]++;
+    out.points[out.label[v]] += out.n[v];
+  }
+
+  for (int i = 0; i < npoints; i++) {
+    double* box = &out.box[6*(size_t) out.label[out.voxel[i]]];
+    box[0] = std::min(box[0], X[i]); box[3] = std::max(box[3], X[i]);
+    box[1] = std::min(box[1], Y[i]); box[4] = std::max(box[4], Y[i]);
+    box[2] = std::min(box[2], Z[i]); box[5] = std::max(box[5], Z[i]);
+  }
+
+  return true;
+}
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef CORE_VOXEL_COUNTS_H
+#define CORE_VOXEL_COUNTS_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "morton.h"
+
+//Occupied voxels of a cloud with their centers and number of points,
+//in order of appearance of their first point in the cloud
+struct Voxels {
+  double edge[3] = {0, 0, 0};
+  std::vector<double> x;
+  std::vector<double> y;
+  std::vector<double> z;
+  std::vector<int> n;
+  //Optional inverted index, the points of voxel v are points[start[v]] to points[start[v + 1] - 1]
+  std::vector<int> start;
+  std::vector<int> points;
+};
+
+//Returns false if the edge length is too small for the extent of the cloud.
+//If index, the points are also sorted by voxel, in order of appearance
+//within each voxel.
+inline bool voxel_counts(const double* X, const double* Y, const double* Z, int npoints, const double* edge_length, Voxels& voxels,
+                         bool index = false) {
+
+  for (int a = 0; a < 3; a++) {
+    voxels.edge[a] = edge_length[a];
+  }
+
+  voxels.x.clear();
+  voxels.y.clear();
+  voxels.z.clear();
+  voxels.n.clear();
+  voxels.start.clear();
+  voxels.points.clear();
+
+  if (npoints == 0) {
+    if (index) {
+      voxels.start.push_back(0);
+    }
+    return true;
+  }
+
+  double min[3] = {X[0], Y[0], Z[0]};
+  double max[3] = {X[0], Y[0], Z[0]};
+
+  for (int i = 1; i < npoints; i++) {
+    min[0] = std::min(min[0], X[i]); max[0] = std::max(max[0], X[i]);
+    min[1] = std::min(min[1], Y[i]); max[1] = std::max(max[1], Y[i]);
+    min[2] = std::min(min[2], Z[i]); max[2] = std::max(max[2], Z[i]);
+  }
+
+  for (int a = 0; a < 3; a++) {
+    if (std::floor((max[a] - min[a])/edge_length[a]) >= MORTON_MAX) {
+      return false;
+    }
+  }
+
+  //Morton code of the voxel of each point
+  std::vector<uint64_t> codes(npoints);
+
+#pragma omp parallel for
+  for (int i = 0; i < npoints; i++) {
+    codes[i] = morton_code((int64_t) std::floor((X[i] - min[0])/edge_length[0]),
+                           (int64_t) std::floor((Y[i] - min[1])/edge_length[1]),
+                           (int64_t) std::floor((Z[i] - min[2])/edge_length[2]));
+  }
+
+  //Clouds sorted with morton_order() are already grouped by voxel
+  std::vector<int> order;
+  bool sorted = morton_sorted(codes);
+
+  if (!sorted) {
+    morton_sort(codes, order);
+  }
+
+  //Runs of equal codes are the voxels, with the first point of the cloud in each
+  std::vector<int> first;
+  std::vector<int> count;
+  std::vector<int> run_start;
+
+  for (int s = 0; s < npoints; s++) {
+    int i = sorted ? s : order[s];
+    if (s == 0 || codes[s] != codes[s - 1]) {
+      first.push_back(i);
+      count.push_back(1);
+      run_start.push_back(s);
+    } else {
+      first.back() = std::min(first.back(), i);
+      count.back()++;
+    }
+  }
+
+  int nvoxels = first.size();
+
+  //Voxels in order of appearance in the cloud
+  std::vector<int> rank(nvoxels);
+  for (int v = 0; v < nvoxels; v++) {
+    rank[v] = v;
+  }
+
+  if (!sorted) {
+    std::sort(rank.begin(), rank.end(), [&](int a, int b) {
+      return first[a] < first[b];
+    });
+  }
+
+  voxels.x.resize(nvoxels);
+  voxels.y.resize(nvoxels);
+  voxels.z.resize(nvoxels);
+  voxels.n.resize(nvoxels);
+
+#pragma omp parallel for
+  for (int v = 0; v < nvoxels; v++) {
+
+    int i = first[rank[v]];
+
+    int xvox = std::floor(((X[i] - min[0])/edge_length[0]));
+    int yvox = std::floor(((Y[i] - min[1])/edge_length[1]));
+    int zvox = std::floor(((Z[i] - min[2])/edge_length[2]));
+
+    voxels.x[v] = min[0] + (xvox*edge_length[0]) + (edge_length[0]/2);
+    voxels.y[v] = min[1] + (yvox*edge_length[1]) + (edge_length[1]/2);
+    voxels.z[v] = min[2] + (zvox*edge_length[2]) + (edge_length[2]/2);
+    voxels.n[v] = count[rank[v]];
+  }
+
+  if (index) {
+
+    voxels.start.resize(nvoxels + 1);
+    voxels.start[0] = 0;
+    for (int v = 0; v < nvoxels; v++) {
+      voxels.start[v + 1] = voxels.start[v] + voxels.n[v];
+    }
+
+    voxels.points.resize(npoints);
+
+    //The radix sort is stable, so each run keeps the order of the cloud
+#pragma omp parallel for
+    for (int v = 0; v < nvoxels; v++) {
+      int from = run_start[rank[v]];
+      for (int k = 0; k < voxels.n[v]; k++) {
+        voxels.points[voxels.start[v] + k] = sorted ? from + k : order[from + k];
+      }
+    }
+  }
+
+  return true;
+}
+
+//Mean, minimum and maximum of each column of values (npoints x ncols,
+//column major) on the points of each voxel of the index. out receives
+//nvoxels x (3*ncols) values, column major, with the means of the columns
+//followed by their minimums and maximums. NaN values are skipped.
+inline void voxel_aggregate(const Voxels& voxels, const double* values, int npoints, int ncols, std::vector<double>& out) {
+
+  int nvoxels = (int) voxels.start.size() - 1;
+  size_t stride = (size_t) nvoxels*ncols;
+
+  out.assign(3*stride, std::numeric_limits<double>::quiet_NaN());
+
+#pragma omp parallel for schedule(dynamic, 256)
+  for (int v = 0; v < nvoxels; v++) {
+    for (int c = 0; c < ncols; c++) {
+
+      const double* column = values + (size_t) c*npoints;
+      double sum = 0;
+      double low = std::numeric_limits<double>::infinity();
+      double high = -std::numeric_limits<double>::infinity();
+      int valid = 0;
+
+      for (int k = voxels.start[v]; k < voxels.start[v + 1]; k++) {
+        double value = column[voxels.points[k]];
+        if (std::isnan(value)) {
+          continue;
+        }
+        sum += value;
+        low = std::min(low, value);
+        high = std::max(high, value);
+        valid++;
+      }
+
+      if (valid > 0) {
+        size_t cell = (size_t) c*nvoxels + v;
+        out[cell] = sum/valid;
+        out[stride + cell] = low;
+        out[2*stride + cell] = high;
+      }
+    }
+  }
+}
+
+#endif
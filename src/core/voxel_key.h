@@ -0,0 +1,35 @@
+#ifndef VOXEL_KEY_H
+#define VOXEL_KEY_H
+
+#include <cmath>
+#include <cstdint>
+
+//Voxels are indexed from the minimum XYZ as in voxelization_rcpp and
+//packed on 21 bits per axis into a single key.
+static const int64_t VOXEL_KEY_MAX = (int64_t) 1 << 21;
+
+inline int64_t voxel_index(double value, double min, double edge) {
+  return (int64_t) floor((value - min)/edge);
+}
+
+inline uint64_t voxel_key(int64_t ix, int64_t iy, int64_t iz) {
+  return (uint64_t) ix | ((uint64_t) iy << 21) | ((uint64_t) iz << 42);
+}
+
+inline void voxel_unkey(uint64_t key, int64_t& ix, int64_t& iy, int64_t& iz) {
+  ix = key & (VOXEL_KEY_MAX - 1);
+  iy = (key >> 21) & (VOXEL_KEY_MAX - 1);
+  iz = (key >> 42) & (VOXEL_KEY_MAX - 1);
+}
+
+//Mixing of keys for hash tables and for splitting keys between threads
+inline uint64_t voxel_hash(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  return key;
+}
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef CORE_VOXEL_MESH_H
+#define CORE_VOXEL_MESH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "voxel_key.h"
+
+//Faces and edges of a set of voxels to draw them at once
+struct VoxelMesh {
+  std::vector<double> quads;   //Four vertices per face, interleaved XYZ, counter-clockwise from outside
+  std::vector<int> voxel;      //Voxel of each face
+  std::vector<double> edges;   //Two vertices per edge, interleaved XYZ
+};
+
+//Mesh of the voxels with centers XYZ. If cull, faces shared by two voxels are
+//removed, so only the surface of each group of voxels is drawn. Edges of the
+//drawn faces are returned once. Returns false if the voxels are too far apart
+//for their edge length.
+inline bool voxel_mesh(const double* X, const double* Y, const double* Z, int nvoxels, const double* edge_length,
+                       bool cull, VoxelMesh& mesh) {
+
+  mesh.quads.clear();
+  mesh.voxel.clear();
+  mesh.edges.clear();
+
+  if (nvoxels == 0) {
+    return true;
+  }
+
+  const double* centers[3] = {X, Y, Z};
+  double min[3] = {X[0], Y[0], Z[0]};
+  double max[3] = {X[0], Y[0], Z[0]};
+
+  for (int v = 1; v < nvoxels; v++) {
+    for (int a = 0; a < 3; a++) {
+      min[a] = std::min(min[a], centers[a][v]);
+      max[a] = std::max(max[a], centers[a][v]);
+    }
+  }
+
+  //Corners of the voxels on each axis
+  double lattice_size = 3;
+  int64_t corners_per_axis[3];
+
+  for (int a = 0; a < 3; a++) {
+    if (std::llround((max[a] - min[a])/edge_length[a]) >= VOXEL_KEY_MAX) {
+      return false;
+    }
+    corners_per_axis[a] = std::llround((max[a] - min[a])/edge_length[a]) + 2;
+    lattice_size *= corners_per_axis[a];
+  }
+
+  //Edges are keyed by their first corner and axis
+  if (lattice_size >= 18446744073709551615.0) {
+    return false;
+  }
+
+  //Index of the voxels on the grid of their centers
+  std::vector<int64_t> index(3*(size_t) nvoxels);
+  std::vector<uint64_t> keys(nvoxels);
+
+#pragma omp parallel for
+  for (int v = 0; v < nvoxels; v++) {
+    for (int a = 0; a < 3; a++) {
+      index[3*(size_t) v + a] = std::llround((centers[a][v] - min[a])/edge_length[a]);
+    }
+    keys[v] = voxel_key(index[3*(size_t) v], index[3*(size_t) v + 1], index[3*(size_t) v + 2]);
+  }
+
+  std::vector<uint64_t> sorted(keys);
+  std::sort(sorted.begin(), sorted.end());
+
+  //Visible faces of each voxel, bit 2*a for the negative side of axis a and 2*a + 1 for the positive
+  std::vector<unsigned char> visible(nvoxels, 63);
+
+  if (cull) {
+
+#pragma omp parallel for
+    for (int v = 0; v < nvoxels; v++) {
+
+      const int64_t* c = &index[3*(size_t) v];
+      unsigned char faces = 0;
+
+      for (int a = 0; a < 3; a++) {
+        for (int side = 0; side < 2; side++) {
+
+          int64_t n[3] = {c[0], c[1], c[2]};
+          n[a] += side == 0 ? -1 : 1;
+
+          bool occupied = false;
+          if (n[a] >= 0 && n[a] < VOXEL_KEY_MAX) {
+            occupied = std::binary_search(sorted.begin(), sorted.end(), voxel_key(n[0], n[1], n[2]));
+          }
+
+          if (!occupied) {
+            faces |= 1 << (2*a + side);
+          }
+        }
+      }
+
+      visible[v] = faces;
+    }
+  }
+
+  //Offsets of the faces of each voxel
+  std::vector<int64_t> first(nvoxels + 1, 0);
+  for (int v = 0; v < nvoxels; v++) {
+    int count = 0;
+    for (int f = 0; f < 6; f++) {
+      count += (visible[v] >> f) & 1;
+    }
+    first[v + 1] = first[v] + count;
+  }
+
+  int64_t nfaces = first[nvoxels];
+
+  mesh.quads.resize(12*(size_t) nfaces);
+  mesh.voxel.resize(nfaces);
+
+  std::vector<uint64_t> edges(4*(size_t) nfaces);
+
+  //Corners of a face on the other two axes, counter-clockwise around the positive axis
+  static const int corners[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+
+#pragma omp parallel for
+  for (int v = 0; v < nvoxels; v++) {
+
+    const int64_t* c = &index[3*(size_t) v];
+    int64_t face = first[v];
+
+    for (int a = 0; a < 3; a++) {
+
+      int u = (a + 1) % 3;
+      int w = (a + 2) % 3;
+
+      for (int side = 0; side < 2; side++) {
+
+        if (((visible[v] >> (2*a + side)) & 1) == 0) {
+          continue;
+        }
+
+        int64_t lattice[4][3];
+
+        for (int k = 0; k < 4; k++) {
+          //The negative side goes around clockwise, so it faces outside
+          int corner = (side == 1) ? k : 3 - k;
+          lattice[k][a] = c[a] + side;
+          lattice[k][u] = c[u] + corners[corner][0];
+          lattice[k][w] = c[w] + corners[corner][1];
+
+          for (int b = 0; b < 3; b++) {
+            mesh.quads[12*(size_t) face + 3*k + b] = min[b] + (lattice[k][b] - 0.5)*edge_length[b];
+          }
+        }
+
+        for (int k = 0; k < 4; k++) {
+          const int64_t* p = lattice[k];
+          const int64_t* q = lattice[(k + 1) % 4];
+          int axis = (p[u] != q[u]) ? u : w;
+          uint64_t key = std::min(p[2], q[2]);
+          key = key*corners_per_axis[1] + std::min(p[1], q[1]);
+          key = key*corners_per_axis[0] + std::min(p[0], q[0]);
+          edges[4*(size_t) face + k] = 3*key + axis;
+        }
+
+        mesh.voxel[face] = v;
+        face++;
+      }
+    }
+  }
+
+  //Edges shared by two faces are drawn once
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+  size_t nedges = edges.size();
+  mesh.edges.resize(6*nedges);
+
+#pragma omp parallel for
+  for (int64_t e = 0; e < (int64_t) nedges; e++) {
+    int axis = edges[e] % 3;
+    uint64_t key = edges[e] / 3;
+    for (int b = 0; b < 3; b++) {
+      double start = min[b] + ((int64_t) (key % corners_per_axis[b]) - 0.5)*edge_length[b];
+      mesh.edges[6*(size_t) e + b] = start;
+      mesh.edges[6*(size_t) e + 3 + b] = start + (b == axis ? edge_length[b] : 0);
+      key /= corners_per_axis[b];
+    }
+  }
+
+  return true;
+}
+
+#endif
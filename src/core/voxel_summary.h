@@ -0,0 +1,198 @@
+#ifndef CORE_VOXEL_SUMMARY_H
+#define CORE_VOXEL_SUMMARY_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "morton.h"
+#include "voxel_counts.h"
+
+//Statistics of the voxels as in summary_voxels without bootstrap
+struct VoxelSummary {
+  int n_voxels = 0;
+  double volume = 0;
+  double surface = 0;
+  double density_mean = 0;
+  double density_sd = 0;
+  double h = 0;
+  double hmax = 0;
+  double equitavility = 0;
+  double negentropy = 0;
+};
+
+//Statistics from the points of each voxel and the number of columns of
+//voxels covering the ground
+inline VoxelSummary voxel_summary_counts(const std::vector<int>& n, int64_t ncolumns, const double* edge) {
+
+  VoxelSummary summary;
+
+  int nvoxels = n.size();
+  double area = edge[0]*edge[1];
+
+  summary.n_voxels = nvoxels;
+  summary.volume = area*edge[2]*nvoxels;
+  summary.surface = ncolumns*area;
+
+  //Density of points and Shannon index of the points per voxel
+  double total = 0;
+  for (int v = 0; v < nvoxels; v++) {
+    total += n[v];
+  }
+
+  for (int v = 0; v < nvoxels; v++) {
+    double p = n[v]/total;
+    summary.h -= p*std::log(p);
+    summary.density_mean += n[v]/area;
+  }
+
+  summary.density_mean /= nvoxels;
+
+  if (nvoxels > 1) {
+    double squares = 0;
+    for (int v = 0; v < nvoxels; v++) {
+      double e = n[v]/area - summary.density_mean;
+      squares += e*e;
+    }
+    summary.density_sd = std::sqrt(squares/(nvoxels - 1));
+  } else {
+    summary.density_sd = std::numeric_limits<double>::quiet_NaN();
+  }
+
+  summary.hmax = std::log((double) nvoxels);
+  summary.equitavility = summary.h/summary.hmax;
+  summary.negentropy = summary.hmax - summary.h;
+
+  return summary;
+}
+
+inline VoxelSummary voxel_summary(const Voxels& voxels) {
+
+  int nvoxels = voxels.n.size();
+
+  //Columns of voxels covering the ground
+  std::vector<std::pair<double, double>> columns(nvoxels);
+  for (int v = 0; v < nvoxels; v++) {
+    columns[v] = std::make_pair(voxels.x[v], voxels.y[v]);
+  }
+  std::sort(columns.begin(), columns.end());
+  int64_t ncolumns = std::unique(columns.begin(), columns.end()) - columns.begin();
+
+  return voxel_summary_counts(voxels.n, ncolumns, voxels.edge);
+}
+
+//Statistics of the voxels of a cloud reduced while the points are grouped by
+//voxel, without building the voxels. The column of a voxel is its Morton
+//code with the bits of Z masked, so the surface is the number of distinct
+//masked codes. Returns false if the edge length is too small for the extent
+//of the cloud.
+inline bool voxel_summary_points(const double* X, const double* Y, const double* Z, int npoints, const double* edge_length,
+                                 VoxelSummary& summary) {
+
+  summary = VoxelSummary();
+
+  if (npoints == 0) {
+    return true;
+  }
+
+  double min[3] = {X[0], Y[0], Z[0]};
+  double max[3] = {X[0], Y[0], Z[0]};
+
+  for (int i = 1; i < npoints; i++) {
+    min[0] = std::min(min[0], X[i]); max[0] = std::max(max[0], X[i]);
+    min[1] = std::min(min[1], Y[i]); max[1] = std::max(max[1], Y[i]);
+    min[2] = std::min(min[2], Z[i]); max[2] = std::max(max[2], Z[i]);
+  }
+
+  for (int a = 0; a < 3; a++) {
+    if (std::floor((max[a] - min[a])/edge_length[a]) >= MORTON_MAX) {
+      return false;
+    }
+  }
+
+  std::vector<uint64_t> codes(npoints);
+
+#pragma omp parallel for
+  for (int i = 0; i < npoints; i++) {
+    codes[i] = morton_code((int64_t) std::floor((X[i] - min[0])/edge_length[0]),
+                           (int64_t) std::floor((Y[i] - min[1])/edge_length[1]),
+                           (int64_t) std::floor((Z[i] - min[2])/edge_length[2]));
+  }
+
+  if (!morton_sorted(codes)) {
+    std::vector<int> order;
+    morton_sort(codes, order);
+  }
+
+  //Runs of equal codes are the voxels
+  const uint64_t column_mask = morton_spread(MORTON_MAX - 1) | (morton_spread(MORTON_MAX - 1) << 1);
+
+  std::vector<int> n;
+  std::vector<uint64_t> columns;
+
+  for (int s = 0; s < npoints; s++) {
+    if (s == 0 || codes[s] != codes[s - 1]) {
+      n.push_back(1);
+      columns.push_back(codes[s] & column_mask);
+    } else {
+      n.back()++;
+    }
+  }
+
+  std::sort(columns.begin(), columns.end());
+  int64_t ncolumns = std::unique(columns.begin(), columns.end()) - columns.begin();
+
+  summary = voxel_summary_counts(n, ncolumns, edge_length);
+
+  return true;
+}
+
+//Statistics of the voxels of groups of points of an inverted index, such as
+//the tiles of a stand, with the edge sizes of each group in row major order
+//(ngroups x nsizes). Groups are reduced in parallel on the calling threads,
+//so the reduction of each group runs serially. Returns false if an edge
+//length is too small for the extent of its group.
+inline bool voxel_summary_groups(const double* X, const double* Y, const double* Z, const Voxels& index,
+                                 const std::vector<int>& groups, const double* edge_sizes, int nsizes,
+                                 std::vector<VoxelSummary>& summaries) {
+
+  int ngroups = groups.size();
+
+  summaries.assign((size_t) ngroups*nsizes, VoxelSummary());
+  std::vector<char> failed(ngroups, 0);
+
+#pragma omp parallel
+{
+  std::vector<double> x, y, z;
+
+#pragma omp for schedule(dynamic, 1)
+  for (int g = 0; g < ngroups; g++) {
+
+    int v = groups[g];
+
+    //Points of the group from the index
+    x.clear();
+    y.clear();
+    z.clear();
+    for (int k = index.start[v]; k < index.start[v + 1]; k++) {
+      x.push_back(X[index.points[k]]);
+      y.push_back(Y[index.points[k]]);
+      z.push_back(Z[index.points[k]]);
+    }
+
+    for (int e = 0; e < nsizes; e++) {
+      double edge = edge_sizes[(size_t) g*nsizes + e];
+      double edge_length[3] = {edge, edge, edge};
+      if (!voxel_summary_points(x.data(), y.data(), z.data(), x.size(), edge_length, summaries[(size_t) g*nsizes + e])) {
+        failed[g] = 1;
+      }
+    }
+  }
+}
+
+  return std::find(failed.begin(), failed.end(), 1) == failed.end();
+}
+
+#endif
@@ -0,0 +1,232 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "core/threads.h"
+
+//Tiles of queries and base points that stay in cache while they are compared
+static const int QUERY_BLOCK = 64;
+static const int BASE_BLOCK = 1024;
+
+// [[Rcpp::export]]
+arma::mat euclidean_many_rcpp(arma::mat query, arma::mat base, int mode = 0, double threshold = 0, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  int nquery = query.n_rows;
+  int nbase = base.n_rows;
+
+  if (mode < 0 || mode > 3) {
+    Rcpp::stop("mode needs to be between 0 and 3");
+  }
+
+  if (mode == 1 && nbase == 0) {
+    Rcpp::stop("base needs at least one point");
+  }
+
+  if ((mode == 2 || mode == 3) && !(std::isfinite(threshold) && threshold >= 0)) {
+    Rcpp::stop("threshold needs to be a finite number greater or equal to zero");
+  }
+
+  const double* QX = query.colptr(0);
+  const double* QY = query.colptr(1);
+  const double* QZ = query.colptr(2);
+  const double* BX = base.colptr(0);
+  const double* BY = base.colptr(1);
+  const double* BZ = base.colptr(2);
+
+  double t2 = threshold*threshold;
+  int nblocks = (nquery + QUERY_BLOCK - 1)/QUERY_BLOCK;
+
+  //Dense distances, only when they are returned
+  if (mode == 0) {
+
+    arma::mat out(nquery, nbase);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int qb = 0; qb < nblocks; qb++) {
+
+      int q0 = qb*QUERY_BLOCK;
+      int q1 = std::min(q0 + QUERY_BLOCK, nquery);
+
+      //Queries are the inner loop to write the columns of out contiguously
+      for (int j = 0; j < nbase; j++) {
+        double bx = BX[j];
+        double by = BY[j];
+        double bz = BZ[j];
+        double* col = out.colptr(j);
+        for (int q = q0; q < q1; q++) {
+          double ex = QX[q] - bx;
+          double ey = QY[q] - by;
+          double ez = QZ[q] - bz;
+          col[q] = sqrt(ex*ex + ey*ey + ez*ez);
+        }
+      }
+    }
+
+    return out;
+  }
+
+  //Minimum and argmin, or count per query
+  if (mode == 1 || mode == 2) {
+
+    arma::mat out(nquery, (mode == 1) ? 2 : 1);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int qb = 0; qb < nblocks; qb++) {
+
+      int q0 = qb*QUERY_BLOCK;
+      int q1 = std::min(q0 + QUERY_BLOCK, nquery);
+
+      double best[QUERY_BLOCK];
+      int arg[QUERY_BLOCK];
+      int count[QUERY_BLOCK];
+
+      for (int q = q0; q < q1; q++) {
+        best[q - q0] = R_PosInf;
+        arg[q - q0] = 0;
+        count[q - q0] = 0;
+      }
+
+      for (int b0 = 0; b0 < nbase; b0 += BASE_BLOCK) {
+
+        int b1 = std::min(b0 + BASE_BLOCK, nbase);
+
+        for (int q = q0; q < q1; q++) {
+
+          double qx = QX[q];
+          double qy = QY[q];
+          double qz = QZ[q];
+
+          if (mode == 1) {
+            //Branch-free minimum of the tile, the argmin only if it improves
+            double tile_best = R_PosInf;
+            for (int j = b0; j < b1; j++) {
+              double ex = BX[j] - qx;
+              double ey = BY[j] - qy;
+              double ez = BZ[j] - qz;
+              tile_best = std::min(tile_best, ex*ex + ey*ey + ez*ez);
+            }
+            if (tile_best < best[q - q0]) {
+              for (int j = b0; j < b1; j++) {
+                double ex = BX[j] - qx;
+                double ey = BY[j] - qy;
+                double ez = BZ[j] - qz;
+                if (ex*ex + ey*ey + ez*ez == tile_best) {
+                  arg[q - q0] = j;
+                  break;
+                }
+              }
+              best[q - q0] = tile_best;
+            }
+          } else {
+            int local_count = 0;
+            for (int j = b0; j < b1; j++) {
+              double ex = BX[j] - qx;
+              double ey = BY[j] - qy;
+              double ez = BZ[j] - qz;
+              local_count += (ex*ex + ey*ey + ez*ez) <= t2;
+            }
+            count[q - q0] += local_count;
+          }
+        }
+      }
+
+      for (int q = q0; q < q1; q++) {
+        if (mode == 1) {
+          out(q, 0) = arg[q - q0] + 1;
+          out(q, 1) = sqrt(best[q - q0]);
+        } else {
+          out(q, 0) = count[q - q0];
+        }
+      }
+    }
+
+    return out;
+  }
+
+  //Pairs within the threshold, in order of query and base
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+
+  std::vector<std::vector<double>> found(nthreads);
+
+#pragma omp parallel num_threads(nthreads)
+{
+  int t = 0;
+#ifdef _OPENMP
+  t = omp_get_thread_num();
+#endif
+
+  //Pairs of each query in the block, in order of base
+  std::vector<std::vector<int>> pairs(QUERY_BLOCK);
+  std::vector<std::vector<double>> d2s(QUERY_BLOCK);
+
+  //Static blocks keep the order when the threads are joined
+#pragma omp for schedule(static)
+  for (int qb = 0; qb < nblocks; qb++) {
+
+    int q0 = qb*QUERY_BLOCK;
+    int q1 = std::min(q0 + QUERY_BLOCK, nquery);
+
+    for (int b0 = 0; b0 < nbase; b0 += BASE_BLOCK) {
+
+      int b1 = std::min(b0 + BASE_BLOCK, nbase);
+
+      for (int q = q0; q < q1; q++) {
+
+        double qx = QX[q];
+        double qy = QY[q];
+        double qz = QZ[q];
+
+        for (int j = b0; j < b1; j++) {
+          double ex = BX[j] - qx;
+          double ey = BY[j] - qy;
+          double ez = BZ[j] - qz;
+          double d2 = ex*ex + ey*ey + ez*ez;
+          if (d2 <= t2) {
+            pairs[q - q0].push_back(j);
+            d2s[q - q0].push_back(d2);
+          }
+        }
+      }
+    }
+
+    for (int q = q0; q < q1; q++) {
+      for (size_t j = 0; j < pairs[q - q0].size(); j++) {
+        found[t].push_back(q + 1);
+        found[t].push_back(pairs[q - q0][j] + 1);
+        found[t].push_back(sqrt(d2s[q - q0][j]));
+      }
+      pairs[q - q0].clear();
+      d2s[q - q0].clear();
+    }
+  }
+}
+
+  size_t nrows = 0;
+  for (int t = 0; t < nthreads; t++) {
+    nrows += found[t].size()/3;
+  }
+
+  arma::mat out(nrows, 3);
+  size_t row = 0;
+
+  for (int t = 0; t < nthreads; t++) {
+    for (size_t j = 0; j < found[t].size(); j += 3) {
+      out(row, 0) = found[t][j];
+      out(row, 1) = found[t][j + 1];
+      out(row, 2) = found[t][j + 2];
+      row++;
+    }
+  }
+
+  return out;
+}
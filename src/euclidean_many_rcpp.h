@@ -0,0 +1,8 @@
+#ifndef EUCLIDEAN_MANY_H
+#define EUCLIDEAN_MANY_H
+
+#include <RcppArmadillo.h>
+
+arma::mat euclidean_many_rcpp(arma::mat query, arma::mat base, int mode = 0, double threshold = 0, int threads = 1);
+
+#endif
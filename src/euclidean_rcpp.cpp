@@ -4,6 +4,7 @@
 // [[Rcpp::plugins(openmp)]]
 // [[Rcpp::depends(Rcpp)]]
 #include <Rcpp.h>
+#include "core/threads.h"
 
 using namespace Rcpp;
 
@@ -12,16 +13,16 @@ Rcpp::NumericVector euclidean_rcpp(Rcpp::NumericVector sample, Rcpp::NumericMatr
 
   NumericVector distance(base.nrow());
 
-#ifdef _OPENMP
-  if ( threads > 0 ) {
-    omp_set_num_threads( threads );
-  }
-#endif
+  ThreadGuard guard(threads);
 
 #pragma omp parallel for
   for (int i = 0; i < base.nrow(); i++) {
 
-    distance[i] = sqrt((pow(base(i, 0) - sample[0], 2.0) + pow(base(i, 1) - sample[1], 2.0) + pow(base(i, 2) - sample[2], 2.0)));
+    double ex = base(i, 0) - sample[0];
+    double ey = base(i, 1) - sample[1];
+    double ez = base(i, 2) - sample[2];
+
+    distance[i] = sqrt(ex*ex + ey*ey + ez*ez);
 
   }
 
@@ -7,17 +7,18 @@
 #include <RcppArmadillo.h>
 #include <progress.hpp>
 #include <progress_bar.hpp>
+#include "core/threads.h"
+#include "core/profiler.h"
+#include "progress_chunk.h"
 
 // [[Rcpp::export]]
 arma::cube features_radius_rcpp(arma::mat index, arma::mat query, arma::vec radius, int threads = 1, bool progress = true) {
 
-  //Set threads
-#ifdef _OPENMP
-  if ( threads > 0 ) {
-    omp_set_num_threads( threads );
-    REprintf("Number of threads=%i\n", omp_get_max_threads());
-  }
-#endif
+  //Threads of the kernel
+  ThreadGuard guard(threads);
+
+  KernelProfile profile("features_radius_rcpp", guard.threads());
+  double start = profile.now();
 
   //query row selection
   arma::vec query_row = index.col(0);
@@ -26,6 +27,8 @@ arma::cube features_radius_rcpp(arma::mat index, arma::mat query, arma::vec radi
   arma::uvec query_unique = find_unique(query_row);
   arma::vec index_query = query_row.elem(query_unique); //unique query
 
+  profile.lap(PHASE_GROUP, start);
+
   //Length of the cube in the 0 dimension
   int an = index_query.n_elem;
 
@@ -38,20 +41,26 @@ arma::cube features_radius_rcpp(arma::mat index, arma::mat query, arma::vec radi
   //create progress
   Progress p(an*len_radius, progress);
 
-#pragma omp parallel for
+#pragma omp parallel
+{
+  ProgressChunk chunk(p);
+
+#pragma omp for schedule(dynamic, 16)
   for (int i = 0; i < an; i++) {
 
+    double lap = profile.now();
+
     //Subset per query index first
     arma::mat sub_index = index.rows(find(query_row == index_query[i]));
 
     //k index
     arma::vec index_radius = sub_index.col(2);
 
+    lap = profile.lap(PHASE_GATHER, lap);
+
     for (int m = 0; m < len_radius; m++) {
 
-      if (! Progress::check_abort() ) {
-        p.increment(); // update progress
-      }
+      chunk.increment(); // update progress
 
       //Subset ref index based on k
       arma::mat ref = sub_index.rows(find(index_radius <= radius[m]));
@@ -69,12 +78,19 @@ arma::cube features_radius_rcpp(arma::mat index, arma::mat query, arma::vec radi
         //Subset points of ref values
         arma::mat points = query.rows(ids_ref);
 
+        profile.scratch(8.0*(sub_index.n_elem + ref.n_elem + points.n_elem));
+        lap = profile.lap(PHASE_GATHER, lap);
+
         //Estimate the cov matrix
         arma::mat covmat =  arma::cov(points);
 
+        lap = profile.lap(PHASE_COVARIANCE, lap);
+
         //Estimate eigen vectors
         arma::vec eigenvalues =  arma::eig_sym(covmat);
 
+        lap = profile.lap(PHASE_EIGEN, lap);
+
         double eigen_total = sum(eigenvalues);
 
         out(i , 0, m) = npoints; //eigenvalue 1
@@ -90,8 +106,13 @@ arma::cube features_radius_rcpp(arma::mat index, arma::mat query, arma::vec radi
         out(i , 3, m) = R_NaN; //eigenvalue 3
 
       }
+
+      lap = profile.lap(PHASE_OUTPUT, lap);
     }
+
+    profile.points(1);
   }
+}
 
   return out;
 }
@@ -0,0 +1,83 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include "core/icp.h"
+#include "core/threads.h"
+
+// [[Rcpp::export]]
+Rcpp::List icp_rcpp(arma::mat source, arma::mat target, arma::mat initial, arma::vec levels, double max_distance, int k = 10, int max_iterations = 50, double tolerance = 1e-6, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  if (source.n_rows < 6 || target.n_rows < 6) {
+    Rcpp::stop("source and target need at least six points");
+  }
+
+  if (initial.n_rows != 4 || initial.n_cols != 4) {
+    Rcpp::stop("initial needs to be a 4x4 matrix");
+  }
+
+  if (max_distance <= 0) {
+    Rcpp::stop("max_distance needs to be positive");
+  }
+
+  if (k < 4) {
+    Rcpp::stop("k needs to be at least 4");
+  }
+
+  IcpSettings settings;
+  settings.max_distance = max_distance;
+  settings.k = k;
+  settings.max_iterations = max_iterations;
+  settings.tolerance = tolerance;
+
+  for (arma::uword l = 0; l < levels.n_elem; l++) {
+    if (levels[l] < 0) {
+      Rcpp::stop("levels need to be positive or zero");
+    }
+    settings.levels.push_back(levels[l]);
+  }
+
+  IcpTarget reference;
+  reference.build(target.colptr(0), target.colptr(1), target.colptr(2), target.n_rows, k);
+
+  IcpResult result;
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      result.transform[4*i + j] = initial(i, j);
+    }
+  }
+
+  icp_register(reference, source.colptr(0), source.colptr(1), source.colptr(2), source.n_rows, settings, result);
+
+  arma::mat transform(4, 4);
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) {
+      transform(i, j) = result.transform[4*i + j];
+    }
+  }
+
+  int nlevels = result.levels.size();
+  arma::mat summary(nlevels, 5);
+  for (int l = 0; l < nlevels; l++) {
+    summary(l, 0) = result.levels[l].distance;
+    summary(l, 1) = result.levels[l].points;
+    summary(l, 2) = result.levels[l].iterations;
+    summary(l, 3) = result.levels[l].correspondences;
+    summary(l, 4) = result.levels[l].rmse;
+  }
+
+  arma::vec residuals(5);
+  residuals[0] = result.correspondences;
+  residuals[1] = result.overlap;
+  residuals[2] = result.rmse;
+  residuals[3] = result.mean;
+  residuals[4] = result.median;
+
+  return Rcpp::List::create(Rcpp::Named("transform") = transform,
+                            Rcpp::Named("levels") = summary,
+                            Rcpp::Named("residuals") = residuals);
+}
@@ -0,0 +1,8 @@
+#ifndef ICP_H
+#define ICP_H
+
+#include <RcppArmadillo.h>
+
+Rcpp::List icp_rcpp(arma::mat source, arma::mat target, arma::mat initial, arma::vec levels, double max_distance, int k = 10, int max_iterations = 50, double tolerance = 1e-6, int threads = 1);
+
+#endif
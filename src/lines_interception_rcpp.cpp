@@ -9,6 +9,9 @@
 #include <progress_bar.hpp>
 #include <iostream>
 #include "line_AABB_rcpp.h"
+#include "core/threads.h"
+#include "core/profiler.h"
+#include "progress_chunk.h"
 
 using namespace arma;
 
@@ -22,24 +25,25 @@ arma::mat lines_interception_rcpp(arma::mat orig, arma::mat end, arma::mat voxel
   //Create matrix of output
   arma::mat interceptions(ng, 9);
 
-  //Parallel
-#ifdef _OPENMP
-  if ( threads > 0 ) {
-    omp_set_num_threads( threads );
-  }
-#endif
+  //Threads of the kernel
+  ThreadGuard guard(threads);
+  KernelProfile profile("lines_interception_rcpp", guard.threads());
 
   //Progress bar
   Progress p(ng, progress);
 
+#pragma omp parallel
+{
+  ProgressChunk chunk(p);
+
   //Loop on bounding boxs
-#pragma omp parallel for
+#pragma omp for schedule(dynamic, 256)
   for (int i = 0; i < ng; i++) {
 
     //Increment progress
-    if (! Progress::check_abort() ) {
-      p.increment(); // update progress
-    }
+    chunk.increment();
+
+    double lap = profile.now();
 
     //Define min and max bounding box
     arma::vec voxel_min(3);
@@ -67,6 +71,8 @@ arma::mat lines_interception_rcpp(arma::mat orig, arma::mat end, arma::mat voxel
     double path_3 = 0; //Points with enter without exit
     double path_4 = 0; //Points with enter and exit
 
+    lap = profile.lap(PHASE_GATHER, lap);
+
     //Loop on rays
     for (int j = 0; j < nrays; j++) {
 
@@ -99,6 +105,8 @@ arma::mat lines_interception_rcpp(arma::mat orig, arma::mat end, arma::mat voxel
       }
     }
 
+    lap = profile.lap(PHASE_INTERSECT, lap);
+
     interceptions(i, 0) = code_0;
     interceptions(i, 1) = code_1;
     interceptions(i, 2) = code_2;
@@ -108,6 +116,11 @@ arma::mat lines_interception_rcpp(arma::mat orig, arma::mat end, arma::mat voxel
     interceptions(i, 6) = path_2;
     interceptions(i, 7) = path_3;
     interceptions(i, 8) = path_4;
+
+    profile.lap(PHASE_OUTPUT, lap);
+    profile.points(1);
   }
+}
+
   return interceptions;
 }
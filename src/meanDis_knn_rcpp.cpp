@@ -7,6 +7,9 @@
 #include <RcppArmadillo.h>
 #include <progress.hpp>
 #include <progress_bar.hpp>
+#include "core/threads.h"
+#include "core/profiler.h"
+#include "progress_chunk.h"
 
 using arma::sqrt;
 using arma::pow;
@@ -18,12 +21,9 @@ using namespace arma;
 // [[Rcpp::export]]
 arma::vec meanDis_knn_rcpp(arma::mat amat, int k, int threads = 1, bool progress = true) {
 
-#ifdef _OPENMP
-  if ( threads > 0 ) {
-    omp_set_num_threads( threads );
-    REprintf("Number of threads=%i\n", omp_get_max_threads());
-  }
-#endif
+  ThreadGuard guard(threads);
+
+  KernelProfile profile("meanDis_knn_rcpp", guard.threads());
 
   int an = amat.n_rows;
 
@@ -31,9 +31,15 @@ arma::vec meanDis_knn_rcpp(arma::mat amat, int k, int threads = 1, bool progress
 
   Progress p(an, progress);
 
-#pragma omp parallel for
+#pragma omp parallel
+{
+  ProgressChunk chunk(p);
+
+#pragma omp for schedule(dynamic, 64)
   for (int i = 0; i < an; i++) {
 
+    double lap = profile.now();
+
     arma::vec distance(an);
 
     for (int j = 0; j < an; j++) { //Loop to estimate the distance
@@ -43,14 +49,19 @@ arma::vec meanDis_knn_rcpp(arma::mat amat, int k, int threads = 1, bool progress
 
     arma::uvec index = sort_index(distance);
 
+    profile.scratch(8.0*distance.n_elem + sizeof(arma::uword)*index.n_elem);
+    lap = profile.lap(PHASE_DISTANCE, lap);
+
     arma::vec k_distance = distance.elem(find(index > 0 && index <= k));
 
     out[i] = mean(k_distance);
 
-    if (! Progress::check_abort() ) {
-      p.increment(); // update progress
-    }
+    profile.lap(PHASE_OUTPUT, lap);
+    profile.points(1);
+
+    chunk.increment(); // update progress
   }
+}
 
   return out;
 }
@@ -0,0 +1,176 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include <vector>
+#include "spatial_index.h"
+#include "core/threads.h"
+
+//Keep the closest pair, ties go to the lowest indices
+static inline void closer_pair(double d2, int i, int j, double& best, int& best_i, int& best_j) {
+  if (d2 < best || (d2 == best && (i < best_i || (i == best_i && j < best_j)))) {
+    best = d2;
+    best_i = i;
+    best_j = j;
+  }
+}
+
+//Closest pair among points in the same or adjacent cells
+static void closest_pair_cells(const SpatialGrid& grid, double& best, int& best_i, int& best_j) {
+
+  int ncells = grid.keys.size();
+
+#pragma omp parallel
+{
+  double local_best = R_PosInf;
+  int local_i = 0;
+  int local_j = 0;
+
+#pragma omp for schedule(dynamic, 64)
+  for (int c = 0; c < ncells; c++) {
+
+    uint64_t key = grid.keys[c];
+    int64_t cx = key % grid.dims[0];
+    int64_t cy = (key/grid.dims[0]) % grid.dims[1];
+    int64_t cz = key/grid.dims[0]/grid.dims[1];
+
+    //Same row forward, then the next row and the three rows above
+    for (int r = 0; r < 5; r++) {
+
+      int64_t dy = (r == 0) ? 0 : ((r == 1) ? 1 : r - 3);
+      int64_t dz = (r < 2) ? 0 : 1;
+
+      int from, to;
+      grid.row((r == 0) ? cx : cx - 1, cx + 1, cy + dy, cz + dz, from, to);
+
+      for (int s = grid.start[c]; s < grid.start[c + 1]; s++) {
+
+        double qx = grid.xyz[3*(size_t) s];
+        double qy = grid.xyz[3*(size_t) s + 1];
+        double qz = grid.xyz[3*(size_t) s + 2];
+
+        for (int t = (r == 0) ? s + 1 : from; t < to; t++) {
+
+          double ex = grid.xyz[3*(size_t) t] - qx;
+          double ey = grid.xyz[3*(size_t) t + 1] - qy;
+          double ez = grid.xyz[3*(size_t) t + 2] - qz;
+          double dist = ex*ex + ey*ey + ez*ez;
+
+          if (dist <= local_best) {
+            int i = grid.id[s];
+            int j = grid.id[t];
+            closer_pair(dist, std::min(i, j), std::max(i, j), local_best, local_i, local_j);
+          }
+        }
+      }
+    }
+  }
+
+#pragma omp critical
+  closer_pair(local_best, local_i, local_j, best, best_i, best_j);
+}
+}
+
+// [[Rcpp::export]]
+Rcpp::List min_distance_rcpp(arma::mat cloud, int breaks = 0, int threads = 1, SEXP index = R_NilValue) {
+
+  ThreadGuard guard(threads);
+
+  int npoints = cloud.n_rows;
+
+  if (npoints < 2) {
+    Rcpp::stop("The cloud needs at least two points");
+  }
+
+  //Use the index if it was already built
+  SpatialGrid local;
+  const SpatialGrid* grid = &local;
+
+  if (Rf_isNull(index)) {
+    local.build(cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), npoints);
+  } else {
+    grid = spatial_index_grid(index);
+    if (grid->n != npoints) {
+      Rcpp::stop("The spatial index was not created from the same cloud");
+    }
+  }
+
+  double best = R_PosInf;
+  int best_i = 0;
+  int best_j = 0;
+
+  //Pairs closer than a cell are in neighbor cells, so the closest pair is
+  //searched on a half stencil of each cell unless the histogram is needed
+  if (breaks <= 0) {
+    closest_pair_cells(*grid, best, best_i, best_j);
+  }
+
+  //Sparse clouds or the histogram need the nearest neighbor of every point
+  std::vector<double> nearest;
+  if (breaks > 0) {
+    nearest.resize(npoints);
+  }
+
+  if (breaks > 0 || best > grid->cell*grid->cell) {
+
+    best = R_PosInf;
+
+#pragma omp parallel
+{
+  double local_best = R_PosInf;
+  int local_i = 0;
+  int local_j = 0;
+
+  //Points in cell order so neighbor queries touch nearby memory
+#pragma omp for schedule(dynamic, 256)
+  for (int s = 0; s < npoints; s++) {
+
+    int i = grid->id[s];
+    int j;
+    double d2;
+
+    grid->knn(grid->xyz[3*(size_t) s], grid->xyz[3*(size_t) s + 1], grid->xyz[3*(size_t) s + 2], 1, i, &j, &d2);
+
+    if (breaks > 0) {
+      nearest[i] = sqrt(d2);
+    }
+
+    closer_pair(d2, std::min(i, j), std::max(i, j), local_best, local_i, local_j);
+  }
+
+#pragma omp critical
+  closer_pair(local_best, local_i, local_j, best, best_i, best_j);
+}
+  }
+
+  //Equal bins from the minimum to the maximum nearest neighbor distance
+  arma::mat histogram(std::max(breaks, 0), 3, arma::fill::zeros);
+
+  if (breaks > 0) {
+
+    double lo = nearest[0];
+    double hi = nearest[0];
+    for (int i = 1; i < npoints; i++) {
+      lo = std::min(lo, nearest[i]);
+      hi = std::max(hi, nearest[i]);
+    }
+
+    double width = (hi - lo)/breaks;
+
+    for (int b = 0; b < breaks; b++) {
+      histogram(b, 0) = lo + b*width;
+      histogram(b, 1) = (b == breaks - 1) ? hi : lo + (b + 1)*width;
+    }
+
+    for (int i = 0; i < npoints; i++) {
+      int b = (width > 0) ? (int) ((nearest[i] - lo)/width) : 0;
+      histogram(std::min(b, breaks - 1), 2) += 1;
+    }
+  }
+
+  return Rcpp::List::create(Rcpp::Named("distance") = sqrt(best),
+                            Rcpp::Named("pair") = Rcpp::IntegerVector::create(best_i + 1, best_j + 1),
+                            Rcpp::Named("histogram") = histogram);
+}
@@ -0,0 +1,8 @@
+#ifndef MIN_DISTANCE_H
+#define MIN_DISTANCE_H
+
+#include <RcppArmadillo.h>
+
+Rcpp::List min_distance_rcpp(arma::mat cloud, int breaks = 0, int threads = 1, SEXP index = R_NilValue);
+
+#endif
@@ -0,0 +1,60 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include <vector>
+#include "spatial_index.h"
+#include "core/min_neighbors.h"
+#include "core/threads.h"
+
+// [[Rcpp::export]]
+Rcpp::LogicalVector min_neighbors_rcpp(arma::mat cloud, double radius, int min_neighbours, int threads = 1, SEXP index = R_NilValue) {
+
+  ThreadGuard guard(threads);
+
+  int npoints = cloud.n_rows;
+
+  if (radius <= 0) {
+    Rcpp::stop("radius needs to be positive");
+  }
+
+  if (npoints == 0) {
+    return Rcpp::LogicalVector(0);
+  }
+
+  Rcpp::LogicalVector keep(npoints);
+
+  if (min_neighbours <= 0) {
+    std::fill(keep.begin(), keep.end(), true);
+    return keep;
+  }
+
+  //Cells with a diagonal equal to the radius, so points sharing a cell are neighbors
+  double cell = radius/sqrt(3.0);
+  bool dense;
+
+  SpatialGrid local;
+  const SpatialGrid* grid = &local;
+
+  if (Rf_isNull(index)) {
+    local.build(cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), npoints, cell);
+    dense = local.cell == cell; //The cell is larger if clamped to the extent of the cloud
+  } else {
+    grid = spatial_index_grid(index);
+    if (grid->n != npoints) {
+      Rcpp::stop("The spatial index was not created from the same cloud");
+    }
+    dense = grid->cell <= cell;
+  }
+
+  std::vector<char> mask;
+  min_neighbors(*grid, radius, min_neighbours, dense, mask);
+
+  for (int i = 0; i < npoints; i++) {
+    keep[i] = mask[i];
+  }
+
+  return keep;
+}
@@ -0,0 +1,8 @@
+#ifndef MIN_NEIGHBORS_H
+#define MIN_NEIGHBORS_H
+
+#include <RcppArmadillo.h>
+
+Rcpp::LogicalVector min_neighbors_rcpp(arma::mat cloud, double radius, int min_neighbours, int threads = 1, SEXP index = R_NilValue);
+
+#endif
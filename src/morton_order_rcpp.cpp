@@ -0,0 +1,70 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include <vector>
+#include "core/morton.h"
+#include "core/threads.h"
+
+using namespace arma;
+
+// [[Rcpp::export]]
+Rcpp::List morton_order_rcpp(arma::mat cloud, arma::vec edge_length, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  int npoints = cloud.n_rows;
+
+  //Zero edges ask for the finest cells, otherwise the three need to be positive
+  bool finest = edge_length.n_elem == 3 && edge_length[0] == 0 && edge_length[1] == 0 && edge_length[2] == 0;
+  if (edge_length.n_elem != 3 || !(finest || (edge_length[0] > 0 && edge_length[1] > 0 && edge_length[2] > 0))) {
+    Rcpp::stop("edge_length needs three positive values");
+  }
+
+  const double* X = cloud.colptr(0);
+  const double* Y = cloud.colptr(1);
+  const double* Z = cloud.colptr(2);
+
+  double min[3] = {arma::min(cloud.col(0)), arma::min(cloud.col(1)), arma::min(cloud.col(2))};
+  double max[3] = {arma::max(cloud.col(0)), arma::max(cloud.col(1)), arma::max(cloud.col(2))};
+  double edge[3] = {edge_length[0], edge_length[1], edge_length[2]};
+
+  //Finest cubic cells that fit on 21 bits if the edge is not given
+  if (finest) {
+    double extent = std::max(max[0] - min[0], std::max(max[1] - min[1], max[2] - min[2]));
+    double cell = std::max(extent/(MORTON_MAX - 1), 1e-12);
+    edge[0] = edge[1] = edge[2] = cell;
+  }
+
+  for (int a = 0; a < 3; a++) {
+    if (floor((max[a] - min[a])/edge[a]) >= MORTON_MAX) {
+      Rcpp::stop("edge_length is too small for the extent of the cloud");
+    }
+  }
+
+  std::vector<uint64_t> codes(npoints);
+
+#pragma omp parallel for
+  for (int i = 0; i < npoints; i++) {
+    codes[i] = morton_code((int64_t) floor((X[i] - min[0])/edge[0]),
+                           (int64_t) floor((Y[i] - min[1])/edge[1]),
+                           (int64_t) floor((Z[i] - min[2])/edge[2]));
+  }
+
+  std::vector<int> order;
+  morton_sort(codes, order);
+
+  Rcpp::IntegerVector sorted(npoints);
+  Rcpp::IntegerVector inverse(npoints);
+
+#pragma omp parallel for
+  for (int s = 0; s < npoints; s++) {
+    sorted[s] = order[s] + 1;
+    inverse[order[s]] = s + 1;
+  }
+
+  return Rcpp::List::create(Rcpp::Named("order") = sorted,
+                            Rcpp::Named("inverse") = inverse);
+}
@@ -0,0 +1,8 @@
+#ifndef MORTON_ORDER_H
+#define MORTON_ORDER_H
+
+#include <RcppArmadillo.h>
+
+Rcpp::List morton_order_rcpp(arma::mat cloud, arma::vec edge_length, int threads = 1);
+
+#endif
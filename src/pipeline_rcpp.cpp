@@ -0,0 +1,85 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include "core/pipeline.h"
+#include "core/threads.h"
+
+// [[Rcpp::export]]
+Rcpp::List pipeline_rcpp(arma::mat cloud, Rcpp::List stages, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  int npoints = cloud.n_rows;
+
+  std::vector<PipelineStage> plan(stages.size());
+
+  for (int s = 0; s < stages.size(); s++) {
+    Rcpp::List stage = stages[s];
+    Rcpp::NumericVector values = stage["values"];
+    plan[s].type = Rcpp::as<int>(stage["type"]);
+    plan[s].values.assign(values.begin(), values.end());
+  }
+
+  PipelineResult result;
+  std::string error;
+
+  if (!pipeline_run(cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), npoints, plan, result, error)) {
+    Rcpp::stop(error);
+  }
+
+  if (result.output == OUTPUT_SUMMARY) {
+
+    const VoxelSummary& summary = result.summary;
+
+    //Standard deviation of a single voxel as in sd()
+    double density_sd = std::isnan(summary.density_sd) ? NA_REAL : summary.density_sd;
+
+    Rcpp::NumericVector values = Rcpp::NumericVector::create(summary.n_voxels, summary.volume, summary.surface,
+                                                             summary.density_mean, density_sd, summary.h,
+                                                             summary.hmax, summary.equitavility, summary.negentropy);
+
+    return Rcpp::List::create(Rcpp::Named("output") = (int) OUTPUT_SUMMARY,
+                              Rcpp::Named("summary") = values);
+  }
+
+  if (result.output == OUTPUT_VOXELS) {
+
+    const Voxels& voxels = result.voxels;
+    int nvoxels = voxels.n.size();
+
+    arma::mat table(nvoxels, 4);
+
+    for (int v = 0; v < nvoxels; v++) {
+      table(v, 0) = voxels.x[v];
+      table(v, 1) = voxels.y[v];
+      table(v, 2) = voxels.z[v];
+      table(v, 3) = voxels.n[v];
+    }
+
+    return Rcpp::List::create(Rcpp::Named("output") = (int) OUTPUT_VOXELS,
+                              Rcpp::Named("voxels") = table);
+  }
+
+  //Coordinates of the points left, with their polar coordinates if they were estimated
+  const PipelineCloud& points = result.cloud;
+  int n = points.size();
+  int ncolumns = points.polar ? COLUMN_N : 3;
+
+  arma::mat columns(n, ncolumns);
+  Rcpp::IntegerVector rows(n);
+
+  for (int b = 0; b < ncolumns; b++) {
+    std::copy(points.columns[b].begin(), points.columns[b].end(), columns.colptr(b));
+  }
+
+  for (int i = 0; i < n; i++) {
+    rows[i] = points.rows[i] + 1;
+  }
+
+  return Rcpp::List::create(Rcpp::Named("output") = (int) OUTPUT_CLOUD,
+                            Rcpp::Named("cloud") = columns,
+                            Rcpp::Named("rows") = rows);
+}
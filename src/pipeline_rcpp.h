@@ -0,0 +1,8 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <RcppArmadillo.h>
+
+Rcpp::List pipeline_rcpp(arma::mat cloud, Rcpp::List stages, int threads = 1);
+
+#endif
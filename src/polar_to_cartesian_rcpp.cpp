@@ -3,16 +3,13 @@
 #endif
 // [[Rcpp::plugins(openmp)]]
 #include <Rcpp.h>
+#include "core/threads.h"
 using namespace Rcpp;
 
 // [[Rcpp::export]]
 NumericMatrix polar_to_cartesian_rcpp(NumericMatrix polar, int threads = 1) {
 
-#ifdef _OPENMP
-  if ( threads > 0 ) {
-    omp_set_num_threads( threads );
-  }
-#endif
+  ThreadGuard guard(threads);
 
   NumericMatrix cartesian(polar.nrow(), 3);
 
@@ -0,0 +1,57 @@
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include "core/profiler.h"
+
+// [[Rcpp::export]]
+bool profile_enable_rcpp(bool enable) {
+
+  ProfileState& state = profile_state();
+
+  bool previous = state.enabled;
+  state.enabled = enable;
+
+  //Reports of calls before profiling was enabled are not kept
+  if (enable) {
+    profile_clear();
+  }
+
+  return previous;
+}
+
+// [[Rcpp::export]]
+Rcpp::List profile_report_rcpp() {
+
+  ProfileState& state = profile_state();
+
+  int nthreads = state.counters.size();
+
+  //Thread time per phase, points and scratch of all threads
+  Rcpp::NumericVector phases(PHASE_N);
+  Rcpp::CharacterVector names(PHASE_N);
+  double points = 0;
+  double scratch = 0;
+
+  for (int ph = 0; ph < PHASE_N; ph++) {
+    names[ph] = PROFILE_PHASES[ph];
+    for (int t = 0; t < nthreads; t++) {
+      phases[ph] += state.counters[t].seconds[ph];
+    }
+  }
+
+  Rcpp::NumericVector thread_points(nthreads);
+
+  for (int t = 0; t < nthreads; t++) {
+    thread_points[t] = state.counters[t].points;
+    points += state.counters[t].points;
+    scratch += state.counters[t].scratch;
+  }
+
+  return Rcpp::List::create(Rcpp::Named("kernel") = state.kernel,
+                            Rcpp::Named("threads") = state.threads,
+                            Rcpp::Named("seconds") = state.seconds,
+                            Rcpp::Named("points") = points,
+                            Rcpp::Named("scratch") = scratch,
+                            Rcpp::Named("phase") = names,
+                            Rcpp::Named("phase_seconds") = phases,
+                            Rcpp::Named("thread_points") = thread_points);
+}
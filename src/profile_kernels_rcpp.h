@@ -0,0 +1,9 @@
+#ifndef PROFILE_KERNELS_H
+#define PROFILE_KERNELS_H
+
+#include <RcppArmadillo.h>
+
+bool profile_enable_rcpp(bool enable);
+Rcpp::List profile_report_rcpp();
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef PROGRESS_CHUNK_H
+#define PROGRESS_CHUNK_H
+
+#include <progress.hpp>
+
+//Iterations counted by a thread before they are added to the progress bar
+static const int PROGRESS_CHUNK = 256;
+
+//Progress of one thread in a parallel loop. Iterations are counted locally
+//and added to the shared bar in chunks, so the bar and the abort check are
+//not synchronised on every point. Create it inside the parallel region.
+class ProgressChunk {
+
+public:
+
+  explicit ProgressChunk(Progress& p) : p(p), count(0) {}
+
+  ~ProgressChunk() {
+    flush();
+  }
+
+  void increment() {
+    if (++count == PROGRESS_CHUNK) {
+      flush();
+    }
+  }
+
+  void flush() {
+    if (count > 0 && !Progress::check_abort()) {
+      p.increment(count);
+    }
+    count = 0;
+  }
+
+  ProgressChunk(const ProgressChunk&) = delete;
+  ProgressChunk& operator=(const ProgressChunk&) = delete;
+
+private:
+
+  Progress& p;
+  int count;
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include <vector>
+#include "core/range_image.h"
+#include "core/threads.h"
+
+// [[Rcpp::export]]
+Rcpp::List range_image_rcpp(arma::mat cloud, arma::vec anchor, arma::vec resolution, arma::vec frame, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  if (anchor.n_elem != 3) {
+    Rcpp::stop("anchor needs to be a numeric vector of length three");
+  }
+
+  if (resolution.n_elem != 2 || resolution[0] <= 0 || resolution[1] <= 0) {
+    Rcpp::stop("resolution needs to be a positive numeric vector of length two");
+  }
+
+  if (frame.n_elem != 4 || frame[1] < frame[0] || frame[3] < frame[2]) {
+    Rcpp::stop("frame needs to be a numeric vector of length four with the min and max of the zenith and azimuth");
+  }
+
+  int npoints = cloud.n_rows;
+
+  RangeImage image;
+
+  if (!range_image_cells(cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), npoints, anchor.memptr(),
+                         resolution.memptr(), frame.memptr(), image)) {
+    Rcpp::stop("resolution is too small for the frame of the scan");
+  }
+
+  //Cell of each point starting at 1, NA outside the frame
+  Rcpp::IntegerVector cell(npoints);
+  Rcpp::NumericVector range(npoints);
+
+  for (int i = 0; i < npoints; i++) {
+    cell[i] = (image.cell[i] < 0) ? NA_INTEGER : (int) (image.cell[i] + 1);
+    range[i] = image.range[i];
+  }
+
+  //Occupied cells with their first and last returns
+  int64_t ncells = image.ncells();
+  std::vector<int64_t> occupied;
+
+  for (int64_t c = 0; c < ncells; c++) {
+    if (image.start[c + 1] > image.start[c]) {
+      occupied.push_back(c);
+    }
+  }
+
+  arma::mat cells(occupied.size(), 6);
+
+  for (size_t o = 0; o < occupied.size(); o++) {
+    int64_t c = occupied[o];
+    cells(o, 0) = c + 1;
+    cells(o, 1) = image.zenith(c);
+    cells(o, 2) = image.azimuth(c);
+    cells(o, 3) = image.start[c + 1] - image.start[c];
+    cells(o, 4) = image.range[image.order[image.start[c]]];
+    cells(o, 5) = image.range[image.order[image.start[c + 1] - 1]];
+  }
+
+  //Empty cells of each row of zenith are missed pulses
+  arma::mat rows(image.rows, 3);
+
+  for (int64_t r = 0; r < image.rows; r++) {
+    int64_t empty = 0;
+    for (int64_t k = 0; k < image.cols; k++) {
+      int64_t c = r*image.cols + k;
+      empty += image.start[c + 1] == image.start[c];
+    }
+    rows(r, 0) = image.zenith(r*image.cols);
+    rows(r, 1) = image.cols;
+    rows(r, 2) = empty;
+  }
+
+  return Rcpp::List::create(Rcpp::Named("cell") = cell,
+                            Rcpp::Named("range") = range,
+                            Rcpp::Named("cells") = cells,
+                            Rcpp::Named("rows") = rows,
+                            Rcpp::Named("dims") = Rcpp::NumericVector::create(image.rows, image.cols),
+                            Rcpp::Named("wrap") = image.wrap);
+}
+
+// [[Rcpp::export]]
+Rcpp::LogicalVector range_image_filter_rcpp(arma::mat cloud, Rcpp::IntegerVector cell, arma::vec range, arma::vec dims, bool wrap,
+                                            double radius, int min_neighbours, int window = 1, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  int npoints = cloud.n_rows;
+
+  if ((int) cell.size() != npoints || (int) range.n_elem != npoints) {
+    Rcpp::stop("The range image was not created from the same cloud");
+  }
+
+  if (window < 0) {
+    Rcpp::stop("window needs to be positive or zero");
+  }
+
+  if (!(radius > 0)) {
+    Rcpp::stop("radius needs to be positive");
+  }
+
+  //The image is an R list that can be modified, so the cells are checked before indexing
+  if (dims.n_elem != 2 || !(dims[0] >= 1 && dims[1] >= 1) || dims[0]*dims[1] >= (double) RANGE_IMAGE_MAX_CELLS) {
+    Rcpp::stop("The dims of the range image are not valid");
+  }
+
+  double ncells = std::floor(dims[0])*std::floor(dims[1]);
+
+  for (int i = 0; i < npoints; i++) {
+    if (cell[i] != NA_INTEGER && (cell[i] < 1 || cell[i] > ncells)) {
+      Rcpp::stop("The cells of the range image are not valid");
+    }
+  }
+
+  //The image is indexed again from the cells, without searching the points
+  RangeImage image;
+  image.rows = dims[0];
+  image.cols = dims[1];
+  image.wrap = wrap;
+  image.cell.resize(npoints);
+  image.range.assign(range.begin(), range.end());
+
+  for (int i = 0; i < npoints; i++) {
+    image.cell[i] = (cell[i] == NA_INTEGER) ? -1 : (int64_t) cell[i] - 1;
+  }
+
+  range_image_index(image);
+
+  std::vector<char> mask;
+  range_image_neighbors(image, cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), radius, min_neighbours, window, mask);
+
+  Rcpp::LogicalVector keep(npoints);
+  for (int i = 0; i < npoints; i++) {
+    keep[i] = mask[i];
+  }
+
+  return keep;
+}
@@ -0,0 +1,10 @@
+#ifndef RANGE_IMAGE_H
+#define RANGE_IMAGE_H
+
+#include <RcppArmadillo.h>
+
+Rcpp::List range_image_rcpp(arma::mat cloud, arma::vec anchor, arma::vec resolution, arma::vec frame, int threads = 1);
+Rcpp::LogicalVector range_image_filter_rcpp(arma::mat cloud, Rcpp::IntegerVector cell, arma::vec range, arma::vec dims, bool wrap,
+                                            double radius, int min_neighbours, int window = 1, int threads = 1);
+
+#endif
@@ -0,0 +1,108 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include <vector>
+#include "core/raster.h"
+#include "core/threads.h"
+
+//Raster of the cloud after checking the arguments
+static RasterGrid raster_of(const arma::mat& cloud, double resolution) {
+
+  if (cloud.n_rows == 0) {
+    Rcpp::stop("cloud needs at least one point");
+  }
+
+  if (resolution <= 0) {
+    Rcpp::stop("resolution needs to be positive");
+  }
+
+  RasterGrid grid;
+
+  if (!raster_grid(cloud.colptr(0), cloud.colptr(1), cloud.n_rows, resolution, grid)) {
+    Rcpp::stop("resolution is too small for the extent of the cloud");
+  }
+
+  return grid;
+}
+
+// [[Rcpp::export]]
+arma::mat raster_rcpp(arma::mat cloud, double resolution, arma::vec probs, bool fill = false, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  if (probs.n_elem > 0 && (probs.min() < 0 || probs.max() > 1)) {
+    Rcpp::stop("probs need to be between 0 and 1");
+  }
+
+  RasterGrid grid = raster_of(cloud, resolution);
+
+  int npoints = cloud.n_rows;
+  int nprobs = probs.n_elem;
+  int64_t ncells = grid.ncells();
+
+  std::vector<double> percentiles(probs.begin(), probs.end());
+  std::vector<double> metrics;
+
+  raster_metrics(grid, cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), npoints, percentiles, metrics);
+
+  //Heights are filled on empty cells, counts stay at 0
+  if (fill) {
+    for (int m = 0; m < 3 + nprobs; m++) {
+      if (m != 2) {
+        raster_fill(grid, &metrics[(size_t) ncells*m]);
+      }
+    }
+  }
+
+  arma::mat out(ncells, 5 + nprobs);
+
+#pragma omp parallel for
+  for (int64_t c = 0; c < ncells; c++) {
+    out(c, 0) = grid.center_x(c);
+    out(c, 1) = grid.center_y(c);
+    for (int m = 0; m < 3 + nprobs; m++) {
+      out(c, 2 + m) = metrics[(size_t) ncells*m + c];
+    }
+  }
+
+  return out;
+}
+
+// [[Rcpp::export]]
+arma::vec normalize_heights_rcpp(arma::mat cloud, double resolution, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  RasterGrid grid = raster_of(cloud, resolution);
+
+  arma::vec heights(cloud.n_rows);
+
+  raster_normalize(grid, cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), cloud.n_rows, heights.memptr());
+
+  return heights;
+}
+
+// [[Rcpp::export]]
+arma::mat ground_rcpp(arma::mat cloud, double resolution, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  RasterGrid grid = raster_of(cloud, resolution);
+
+  std::vector<double> ground;
+  raster_ground(grid, cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), cloud.n_rows, ground);
+
+  int64_t ncells = grid.ncells();
+  arma::mat out(ncells, 3);
+
+  for (int64_t c = 0; c < ncells; c++) {
+    out(c, 0) = grid.center_x(c);
+    out(c, 1) = grid.center_y(c);
+    out(c, 2) = ground[c];
+  }
+
+  return out;
+}
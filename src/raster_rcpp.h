@@ -0,0 +1,10 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <RcppArmadillo.h>
+
+arma::mat raster_rcpp(arma::mat cloud, double resolution, arma::vec probs, bool fill = false, int threads = 1);
+arma::vec normalize_heights_rcpp(arma::mat cloud, double resolution, int threads = 1);
+arma::mat ground_rcpp(arma::mat cloud, double resolution, int threads = 1);
+
+#endif
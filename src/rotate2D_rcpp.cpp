@@ -4,16 +4,13 @@
 // [[Rcpp::plugins(openmp)]]
 
 #include <Rcpp.h>
+#include "core/threads.h"
 using namespace Rcpp;
 
 // [[Rcpp::export]]
 NumericMatrix rotate2D_rcpp(NumericMatrix plane, NumericVector angle, int threads = 1)  {
 
-#ifdef _OPENMP
-  if ( threads > 0 ) {
-    omp_set_num_threads( threads );
-  }
-#endif
+  ThreadGuard guard(threads);
 
   NumericMatrix rotate(plane.nrow(), 2);
 
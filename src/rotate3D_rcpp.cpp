@@ -4,16 +4,13 @@
 // [[Rcpp::plugins(openmp)]]
 
 #include <Rcpp.h>
+#include "core/threads.h"
 using namespace Rcpp;
 
 // [[Rcpp::export]]
 NumericMatrix rotate3D_rcpp(NumericMatrix cloud, NumericVector roll, NumericVector pitch, NumericVector yaw, int threads = 1)  {
 
-#ifdef _OPENMP
-  if ( threads > 0 ) {
-    omp_set_num_threads( threads );
-  }
-#endif
+  ThreadGuard guard(threads);
 
   NumericMatrix rotate(cloud.nrow(), 3);
 
@@ -0,0 +1,91 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "core/splitmix.h"
+#include "core/threads.h"
+
+using namespace arma;
+
+// [[Rcpp::export]]
+arma::vec shannon_boot_rcpp(arma::vec counts, int R, double conf = 0.95, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  //The standard deviation needs two replicates and the interval a level inside (0, 1)
+  if (R < 2) {
+    Rcpp::stop("R needs to be at least 2 bootstrap replicates");
+  }
+  if (!(conf > 0 && conf < 1)) {
+    Rcpp::stop("conf needs to be between 0 and 1");
+  }
+
+  int n = counts.n_elem;
+
+  //Each replicate draws n voxels with replacement, so with S = sum(N) and
+  //T = sum(N*log(N)) of the drawn voxels, H = log(S) - T/S
+  std::vector<double> nlogn(n);
+  for (int i = 0; i < n; i++) {
+    nlogn[i] = counts[i] > 0 ? counts[i]*log(counts[i]) : 0;
+  }
+
+  //Seed from the R generator so set.seed() is respected
+  uint64_t seed = (uint64_t) (unif_rand()*4294967296.0) << 32 | (uint64_t) (unif_rand()*4294967296.0);
+
+  const double* N = counts.memptr();
+  std::vector<double> H(R);
+
+#pragma omp parallel for schedule(static)
+  for (int r = 0; r < R; r++) {
+
+    SplitMix rng(seed ^ ((uint64_t) r * 0xD1B54A32D192ED03ULL));
+
+    double S = 0;
+    double T = 0;
+
+    for (int j = 0; j < n; j++) {
+      int i = std::min((int) (rng.uniform()*n), n - 1);
+      S += N[i];
+      T += nlogn[i];
+    }
+
+    H[r] = log(S) - T/S;
+  }
+
+  double mean = 0;
+  for (int r = 0; r < R; r++) {
+    mean += H[r];
+  }
+  mean /= R;
+
+  double squares = 0;
+  for (int r = 0; r < R; r++) {
+    squares += (H[r] - mean)*(H[r] - mean);
+  }
+
+  //Percentile interval, as type 7 of quantile()
+  std::sort(H.begin(), H.end());
+
+  double probs[2] = {(1 - conf)/2, 1 - (1 - conf)/2};
+  double interval[2];
+
+  for (int p = 0; p < 2; p++) {
+    double h = (R - 1)*probs[p];
+    int lo = floor(h);
+    int hi = std::min(lo + 1, R - 1);
+    interval[p] = H[lo] + (h - lo)*(H[hi] - H[lo]);
+  }
+
+  arma::vec out(4);
+  out[0] = mean;
+  out[1] = sqrt(squares/(R - 1));
+  out[2] = interval[0];
+  out[3] = interval[1];
+
+  return out;
+}
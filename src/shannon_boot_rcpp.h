@@ -0,0 +1,8 @@
+#ifndef SHANNON_BOOT_H
+#define SHANNON_BOOT_H
+
+#include <RcppArmadillo.h>
+
+arma::vec shannon_boot_rcpp(arma::vec counts, int R, double conf = 0.95, int threads = 1);
+
+#endif
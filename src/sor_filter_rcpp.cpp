@@ -0,0 +1,46 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include <vector>
+#include "spatial_index.h"
+#include "core/sor.h"
+#include "core/threads.h"
+
+// [[Rcpp::export]]
+Rcpp::LogicalVector sor_filter_rcpp(arma::mat cloud, int k, double nSigma, int threads = 1, SEXP index = R_NilValue) {
+
+  ThreadGuard guard(threads);
+
+  int npoints = cloud.n_rows;
+
+  if (k < 1 || k >= npoints) {
+    Rcpp::stop("k needs to be between 1 and nrow(cloud) - 1");
+  }
+
+  //Use the index if it was already built
+  SpatialGrid local;
+  const SpatialGrid* grid = &local;
+
+  if (Rf_isNull(index)) {
+    local.build(cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), npoints);
+  } else {
+    grid = spatial_index_grid(index);
+    if (grid->n != npoints) {
+      Rcpp::stop("The spatial index was not created from the same cloud");
+    }
+  }
+
+  std::vector<char> mask;
+  sor_filter(*grid, k, nSigma, mask);
+
+  Rcpp::LogicalVector keep(npoints);
+
+  for (int i = 0; i < npoints; i++) {
+    keep[i] = mask[i];
+  }
+
+  return keep;
+}
@@ -0,0 +1,8 @@
+#ifndef SOR_FILTER_H
+#define SOR_FILTER_H
+
+#include <RcppArmadillo.h>
+
+Rcpp::LogicalVector sor_filter_rcpp(arma::mat cloud, int k, double nSigma, int threads = 1, SEXP index = R_NilValue);
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef SPATIAL_INDEX_PTR_H
+#define SPATIAL_INDEX_PTR_H
+
+#include <RcppArmadillo.h>
+#include "core/spatial_grid.h"
+
+//Grid behind an index created with spatial_index_rcpp
+inline SpatialGrid* spatial_index_grid(SEXP index) {
+  if (TYPEOF(index) != EXTPTRSXP || R_ExternalPtrAddr(index) == NULL) {
+    Rcpp::stop("The spatial index is not valid, it needs to be created or loaded again");
+  }
+  return (SpatialGrid*) R_ExternalPtrAddr(index);
+}
+
+#endif
@@ -0,0 +1,194 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "spatial_index.h"
+#include "core/threads.h"
+
+// [[Rcpp::export]]
+SEXP spatial_index_rcpp(arma::mat cloud, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  if (cloud.n_rows == 0) {
+    Rcpp::stop("The cloud has no points");
+  }
+
+  SpatialGrid* grid = new SpatialGrid(cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), cloud.n_rows);
+
+  return Rcpp::XPtr<SpatialGrid>(grid, true);
+}
+
+// [[Rcpp::export]]
+bool spatial_index_save_rcpp(SEXP index, std::string file) {
+
+  SpatialGrid* grid = spatial_index_grid(index);
+
+  if (!grid->save(file.c_str())) {
+    Rcpp::stop("The spatial index could not be written to the file");
+  }
+
+  return true;
+}
+
+// [[Rcpp::export]]
+SEXP spatial_index_load_rcpp(std::string file) {
+
+  SpatialGrid* grid = new SpatialGrid();
+
+  if (!grid->load(file.c_str())) {
+    delete grid;
+    Rcpp::stop("The file does not contain a valid spatial index");
+  }
+
+  return Rcpp::XPtr<SpatialGrid>(grid, true);
+}
+
+// [[Rcpp::export]]
+arma::vec spatial_index_info_rcpp(SEXP index) {
+
+  SpatialGrid* grid = spatial_index_grid(index);
+
+  arma::vec out(9);
+  out[0] = grid->n;
+  out[1] = grid->cell;
+  out[2] = grid->keys.size();
+
+  //Bounding box of the points, to check the cloud the index is used on
+  for (int a = 0; a < 3; a++) {
+    double lo = R_PosInf, hi = R_NegInf;
+    for (int i = 0; i < grid->n; i++) {
+      lo = std::min(lo, grid->xyz[3*i + a]);
+      hi = std::max(hi, grid->xyz[3*i + a]);
+    }
+    out[3 + a] = lo;
+    out[6 + a] = hi;
+  }
+
+  return out;
+}
+
+// [[Rcpp::export]]
+arma::mat spatial_index_knn_rcpp(SEXP index, arma::mat query, int k, bool same = false, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  const SpatialGrid* grid = spatial_index_grid(index);
+
+  int nquery = query.n_rows;
+
+  if (k < 1 || k > grid->n - (same ? 1 : 0)) {
+    Rcpp::stop("k needs to be between 1 and the number of points in the index");
+  }
+
+  const double* X = query.colptr(0);
+  const double* Y = query.colptr(1);
+  const double* Z = query.colptr(2);
+
+  //Query, ref, k index, and distance as in knn()
+  arma::mat out((size_t) nquery*k, 4);
+
+#pragma omp parallel
+{
+  std::vector<int> idx(k);
+  std::vector<double> d2(k);
+
+#pragma omp for schedule(dynamic, 256)
+  for (int i = 0; i < nquery; i++) {
+
+    grid->knn(X[i], Y[i], Z[i], k, same ? i : -1, idx.data(), d2.data());
+
+    for (int j = 0; j < k; j++) {
+      size_t row = (size_t) i*k + j;
+      out(row, 0) = i + 1;
+      out(row, 1) = idx[j] + 1;
+      out(row, 2) = j + 1;
+      out(row, 3) = sqrt(d2[j]);
+    }
+  }
+}
+
+  return out;
+}
+
+// [[Rcpp::export]]
+arma::mat spatial_index_radius_rcpp(SEXP index, arma::mat query, double radius, int max_neighbour, bool same = false, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  const SpatialGrid* grid = spatial_index_grid(index);
+
+  int nquery = query.n_rows;
+
+  const double* X = query.colptr(0);
+  const double* Y = query.colptr(1);
+  const double* Z = query.colptr(2);
+
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+
+  //Static blocks of queries per thread keep the order when joined
+  std::vector<std::vector<double>> found(nthreads);
+
+#pragma omp parallel num_threads(nthreads)
+{
+  int t = 0;
+#ifdef _OPENMP
+  t = omp_get_thread_num();
+#endif
+
+  std::vector<int> idx;
+  std::vector<double> d2;
+  std::vector<int> order;
+
+#pragma omp for schedule(static)
+  for (int i = 0; i < nquery; i++) {
+
+    grid->radius(X[i], Y[i], Z[i], radius, same ? i : -1, idx, d2);
+
+    order.resize(idx.size());
+    for (size_t j = 0; j < idx.size(); j++) {
+      order[j] = j;
+    }
+
+    //Closest max_neighbour points
+    int keep = std::min((int) idx.size(), max_neighbour);
+    std::partial_sort(order.begin(), order.begin() + keep, order.end(), [&](int a, int b) {
+      return d2[a] < d2[b] || (d2[a] == d2[b] && idx[a] < idx[b]);
+    });
+
+    for (int j = 0; j < keep; j++) {
+      found[t].push_back(i + 1);
+      found[t].push_back(idx[order[j]] + 1);
+      found[t].push_back(sqrt(d2[order[j]]));
+    }
+  }
+}
+
+  size_t nrows = 0;
+  for (int t = 0; t < nthreads; t++) {
+    nrows += found[t].size()/3;
+  }
+
+  //Query, ref, and distance as in radius_search()
+  arma::mat out(nrows, 3);
+  size_t row = 0;
+
+  for (int t = 0; t < nthreads; t++) {
+    for (size_t j = 0; j < found[t].size(); j += 3) {
+      out(row, 0) = found[t][j];
+      out(row, 1) = found[t][j + 1];
+      out(row, 2) = found[t][j + 2];
+      row++;
+    }
+  }
+
+  return out;
+}
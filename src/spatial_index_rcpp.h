@@ -0,0 +1,13 @@
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include <RcppArmadillo.h>
+
+SEXP spatial_index_rcpp(arma::mat cloud, int threads = 1);
+bool spatial_index_save_rcpp(SEXP index, std::string file);
+SEXP spatial_index_load_rcpp(std::string file);
+arma::vec spatial_index_info_rcpp(SEXP index);
+arma::mat spatial_index_knn_rcpp(SEXP index, arma::mat query, int k, bool same = false, int threads = 1);
+arma::mat spatial_index_radius_rcpp(SEXP index, arma::mat query, double radius, int max_neighbour, bool same = false, int threads = 1);
+
+#endif
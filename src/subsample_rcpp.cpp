@@ -0,0 +1,69 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include <vector>
+#include "spatial_index.h"
+#include "core/subsample.h"
+#include "core/threads.h"
+
+// [[Rcpp::export]]
+Rcpp::IntegerVector poisson_disk_rcpp(arma::mat cloud, double distance, int threads = 1, SEXP index = R_NilValue) {
+
+  ThreadGuard guard(threads);
+
+  int npoints = cloud.n_rows;
+
+  if (distance <= 0) {
+    Rcpp::stop("distance needs to be positive");
+  }
+
+  if (npoints == 0) {
+    return Rcpp::IntegerVector(0);
+  }
+
+  //Cells with an edge equal to the distance, so the conflicts are in the adjacent cells
+  SpatialGrid local;
+  const SpatialGrid* grid = &local;
+
+  if (Rf_isNull(index)) {
+    local.build(cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), npoints, distance);
+  } else {
+    grid = spatial_index_grid(index);
+    if (grid->n != npoints) {
+      Rcpp::stop("The spatial index was not created from the same cloud");
+    }
+  }
+
+  std::vector<int> selected;
+  poisson_disk(*grid, distance, selected);
+
+  Rcpp::IntegerVector out(selected.size());
+  for (size_t i = 0; i < selected.size(); i++) {
+    out[i] = selected[i] + 1;
+  }
+
+  return out;
+}
+
+// [[Rcpp::export]]
+Rcpp::IntegerVector random_fraction_rcpp(int npoints, double fraction, double seed, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  if (fraction < 0 || fraction > 1) {
+    Rcpp::stop("fraction needs to be between 0 and 1");
+  }
+
+  std::vector<int> selected;
+  random_fraction(npoints, fraction, (uint64_t) (int64_t) seed, selected);
+
+  Rcpp::IntegerVector out(selected.size());
+  for (size_t i = 0; i < selected.size(); i++) {
+    out[i] = selected[i] + 1;
+  }
+
+  return out;
+}
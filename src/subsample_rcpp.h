@@ -0,0 +1,9 @@
+#ifndef SUBSAMPLE_H
+#define SUBSAMPLE_H
+
+#include <RcppArmadillo.h>
+
+Rcpp::IntegerVector poisson_disk_rcpp(arma::mat cloud, double distance, int threads = 1, SEXP index = R_NilValue);
+Rcpp::IntegerVector random_fraction_rcpp(int npoints, double fraction, double seed, int threads = 1);
+
+#endif
@@ -0,0 +1,198 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include <algorithm>
+#include <climits>
+#include <vector>
+#include "core/threads.h"
+
+using namespace arma;
+
+//Area of the convex hull of XY points using the monotone chain
+static double hull_area(std::vector<double>& x, std::vector<double>& y) {
+
+  int n = x.size();
+
+  std::vector<int> order(n);
+  for (int i = 0; i < n; i++) {
+    order[i] = i;
+  }
+
+  std::sort(order.begin(), order.end(), [&](int a, int b) {
+    return x[a] < x[b] || (x[a] == x[b] && y[a] < y[b]);
+  });
+
+  std::vector<int> hull(2*n);
+  int h = 0;
+
+  //Lower and upper hull
+  for (int pass = 0; pass < 2; pass++) {
+    int start = h;
+    for (int s = 0; s < n; s++) {
+      int i = (pass == 0) ? order[s] : order[n - 1 - s];
+      while (h >= start + 2) {
+        int a = hull[h - 2];
+        int b = hull[h - 1];
+        double cross = (x[b] - x[a])*(y[i] - y[a]) - (y[b] - y[a])*(x[i] - x[a]);
+        if (cross > 0) {
+          break;
+        }
+        h--;
+      }
+      hull[h++] = i;
+    }
+    h--; //Last point is the first of the next chain
+  }
+
+  //Shoelace formula
+  double area = 0;
+  for (int s = 0; s < h; s++) {
+    int a = hull[s];
+    int b = hull[(s + 1) % h];
+    area += x[a]*y[b] - x[b]*y[a];
+  }
+
+  return std::abs(area)/2;
+}
+
+// [[Rcpp::export]]
+arma::mat trunk_slices_rcpp(arma::mat cloud, double thickness, int section = 0, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  int npoints = cloud.n_rows;
+
+  if (!(thickness > 0)) {
+    Rcpp::stop("slice needs to be positive");
+  }
+
+  if (npoints == 0) {
+    Rcpp::stop("The cloud has no points");
+  }
+
+  const double* X = cloud.colptr(0);
+  const double* Y = cloud.colptr(1);
+  const double* Z = cloud.colptr(2);
+
+  double zmin = min(cloud.col(2));
+  double zmax = max(cloud.col(2));
+
+  if ((zmax - zmin)/thickness >= INT_MAX - 1) {
+    Rcpp::stop("slice is too small for the height of the cloud");
+  }
+
+  int nslices = floor((zmax - zmin)/thickness) + 1;
+
+  //Counting sort of the points by slice
+  std::vector<int> slice(npoints);
+  std::vector<int> offsets(nslices + 1, 0);
+
+  for (int i = 0; i < npoints; i++) {
+    slice[i] = std::min((int) floor((Z[i] - zmin)/thickness), nslices - 1);
+    offsets[slice[i] + 1]++;
+  }
+
+  for (int s = 0; s < nslices; s++) {
+    offsets[s + 1] += offsets[s];
+  }
+
+  std::vector<int> sorted(npoints);
+  std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+
+  for (int i = 0; i < npoints; i++) {
+    sorted[fill[slice[i]]++] = i;
+  }
+
+  //Z, N, X, Y, diameter, and area of each slice
+  arma::mat out(nslices, 6);
+
+#pragma omp parallel for schedule(dynamic)
+  for (int s = 0; s < nslices; s++) {
+
+    int n = offsets[s + 1] - offsets[s];
+
+    out(s, 0) = zmin + s*thickness + thickness/2;
+    out(s, 1) = n;
+
+    if (n < 3) {
+      out(s, 2) = R_NaN;
+      out(s, 3) = R_NaN;
+      out(s, 4) = R_NaN;
+      out(s, 5) = R_NaN;
+      continue;
+    }
+
+    //Center the slice to keep the fit stable on projected coordinates
+    double xm = 0;
+    double ym = 0;
+    for (int j = offsets[s]; j < offsets[s + 1]; j++) {
+      xm += X[sorted[j]];
+      ym += Y[sorted[j]];
+    }
+    xm /= n;
+    ym /= n;
+
+    out(s, 2) = xm;
+    out(s, 3) = ym;
+
+    if (section == 0) {
+
+      //Least squares circle of x^2 + y^2 = a*x + b*y + c
+      double sxx = 0, sxy = 0, syy = 0, sx = 0, sy = 0;
+      double sxz = 0, syz = 0, sz = 0;
+
+      for (int j = offsets[s]; j < offsets[s + 1]; j++) {
+        double x = X[sorted[j]] - xm;
+        double y = Y[sorted[j]] - ym;
+        double z = x*x + y*y;
+        sxx += x*x;
+        sxy += x*y;
+        syy += y*y;
+        sx += x;
+        sy += y;
+        sxz += x*z;
+        syz += y*z;
+        sz += z;
+      }
+
+      double det = sxx*(syy*n - sy*sy) - sxy*(sxy*n - sy*sx) + sx*(sxy*sy - syy*sx);
+
+      if (std::abs(det) < 1e-300) {
+        out(s, 4) = R_NaN;
+        out(s, 5) = R_NaN;
+        continue;
+      }
+
+      double a = (sxz*(syy*n - sy*sy) - sxy*(syz*n - sy*sz) + sx*(syz*sy - syy*sz))/det;
+      double b = (sxx*(syz*n - sz*sy) - sxz*(sxy*n - sy*sx) + sx*(sxy*sz - syz*sx))/det;
+      double c = (sxx*(syy*sz - sy*syz) - sxy*(sxy*sz - syz*sx) + sxz*(sxy*sy - syy*sx))/det;
+
+      double radius = sqrt(c + (a*a + b*b)/4);
+
+      out(s, 2) = xm + a/2;
+      out(s, 3) = ym + b/2;
+      out(s, 4) = 2*radius;
+      out(s, 5) = M_PI*radius*radius;
+
+    } else {
+
+      std::vector<double> x(n);
+      std::vector<double> y(n);
+
+      for (int j = 0; j < n; j++) {
+        x[j] = X[sorted[offsets[s] + j]];
+        y[j] = Y[sorted[offsets[s] + j]];
+      }
+
+      double area = hull_area(x, y);
+
+      out(s, 4) = sqrt(area/M_PI)*2;
+      out(s, 5) = area;
+    }
+  }
+
+  return out;
+}
@@ -0,0 +1,8 @@
+#ifndef TRUNK_SLICES_H
+#define TRUNK_SLICES_H
+
+#include <RcppArmadillo.h>
+
+arma::mat trunk_slices_rcpp(arma::mat cloud, double thickness, int section = 0, int threads = 1);
+
+#endif
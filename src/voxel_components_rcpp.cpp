@@ -0,0 +1,62 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include "core/voxel_components.h"
+#include "core/threads.h"
+
+// [[Rcpp::export]]
+Rcpp::List voxel_components_rcpp(arma::mat cloud, arma::vec edge_length, int connectivity = 26, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  if (connectivity != 6 && connectivity != 18 && connectivity != 26) {
+    Rcpp::stop("connectivity needs to be 6, 18, or 26");
+  }
+
+  if (edge_length.n_elem != 3 || !(edge_length[0] > 0 && edge_length[1] > 0 && edge_length[2] > 0)) {
+    Rcpp::stop("edge_length needs three positive values");
+  }
+
+  int npoints = cloud.n_rows;
+
+  VoxelComponents components;
+
+  if (!voxel_components(cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), npoints, edge_length.memptr(), connectivity, components)) {
+    Rcpp::stop("edge_length is too small for the extent of the cloud");
+  }
+
+  int nvoxels = components.n.size();
+  int ncomponents = components.ncomponents;
+
+  //Labels start at 1 as in R
+  Rcpp::IntegerVector points(npoints);
+  for (int i = 0; i < npoints; i++) {
+    points[i] = components.label[components.voxel[i]] + 1;
+  }
+
+  arma::mat voxels(nvoxels, 5);
+  for (int v = 0; v < nvoxels; v++) {
+    voxels(v, 0) = components.xyz[3*(size_t) v];
+    voxels(v, 1) = components.xyz[3*(size_t) v + 1];
+    voxels(v, 2) = components.xyz[3*(size_t) v + 2];
+    voxels(v, 3) = components.n[v];
+    voxels(v, 4) = components.label[v] + 1;
+  }
+
+  arma::mat summary(ncomponents, 9);
+  for (int k = 0; k < ncomponents; k++) {
+    summary(k, 0) = k + 1;
+    summary(k, 1) = components.voxels[k];
+    summary(k, 2) = components.points[k];
+    for (int a = 0; a < 6; a++) {
+      summary(k, 3 + a) = components.box[6*(size_t) k + a];
+    }
+  }
+
+  return Rcpp::List::create(Rcpp::Named("points") = points,
+                            Rcpp::Named("voxels") = voxels,
+                            Rcpp::Named("components") = summary);
+}
@@ -0,0 +1,8 @@
+#ifndef VOXEL_COMPONENTS_H
+#define VOXEL_COMPONENTS_H
+
+#include <RcppArmadillo.h>
+
+Rcpp::List voxel_components_rcpp(arma::mat cloud, arma::vec edge_length, int connectivity = 26, int threads = 1);
+
+#endif
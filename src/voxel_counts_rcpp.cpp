@@ -0,0 +1,113 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include "core/voxel_counts.h"
+#include "core/threads.h"
+
+using namespace arma;
+
+//Zero, negative or NaN edges would reach the casts of the voxel indices
+static void check_edge_length(const arma::vec& edge_length) {
+  if (edge_length.n_elem != 3 || !(edge_length[0] > 0 && edge_length[1] > 0 && edge_length[2] > 0)) {
+    Rcpp::stop("edge_length needs three positive values");
+  }
+}
+
+// [[Rcpp::export]]
+arma::mat voxel_counts_rcpp(arma::mat cloud, arma::vec edge_length, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  check_edge_length(edge_length);
+
+  int npoints = cloud.n_rows;
+
+  Voxels counts;
+
+  if (!voxel_counts(cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), npoints, edge_length.memptr(), counts)) {
+    Rcpp::stop("edge_length is too small for the extent of the cloud");
+  }
+
+  int nvoxels = counts.n.size();
+
+  arma::mat voxels(nvoxels, 4);
+
+  for (int v = 0; v < nvoxels; v++) {
+    voxels(v, 0) = counts.x[v];
+    voxels(v, 1) = counts.y[v];
+    voxels(v, 2) = counts.z[v];
+    voxels(v, 3) = counts.n[v];
+  }
+
+  return voxels;
+}
+
+// [[Rcpp::export]]
+Rcpp::List voxel_index_rcpp(arma::mat cloud, arma::vec edge_length, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  check_edge_length(edge_length);
+
+  int npoints = cloud.n_rows;
+
+  Voxels counts;
+
+  if (!voxel_counts(cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), npoints, edge_length.memptr(), counts, true)) {
+    Rcpp::stop("edge_length is too small for the extent of the cloud");
+  }
+
+  int nvoxels = counts.n.size();
+
+  arma::mat voxels(nvoxels, 4);
+
+  for (int v = 0; v < nvoxels; v++) {
+    voxels(v, 0) = counts.x[v];
+    voxels(v, 1) = counts.y[v];
+    voxels(v, 2) = counts.z[v];
+    voxels(v, 3) = counts.n[v];
+  }
+
+  //Points as rows of the cloud
+  Rcpp::IntegerVector points(npoints);
+  for (int k = 0; k < npoints; k++) {
+    points[k] = counts.points[k] + 1;
+  }
+
+  return Rcpp::List::create(Rcpp::Named("voxels") = voxels,
+                            Rcpp::Named("start") = Rcpp::IntegerVector(counts.start.begin(), counts.start.end()),
+                            Rcpp::Named("points") = points);
+}
+
+// [[Rcpp::export]]
+arma::mat voxel_aggregate_rcpp(arma::mat values, Rcpp::IntegerVector start, Rcpp::IntegerVector points, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  int npoints = values.n_rows;
+
+  Voxels index;
+  index.start.assign(start.begin(), start.end());
+  index.points.resize(points.size());
+
+  for (int k = 0; k < points.size(); k++) {
+    if (points[k] < 1 || points[k] > npoints) {
+      Rcpp::stop("The index does not match the rows of the cloud");
+    }
+    index.points[k] = points[k] - 1;
+  }
+
+  if (index.start.empty() || index.start.back() != (int) index.points.size()) {
+    Rcpp::stop("The index does not match the rows of the cloud");
+  }
+
+  std::vector<double> out;
+  voxel_aggregate(index, values.memptr(), npoints, values.n_cols, out);
+
+  int nvoxels = index.start.size() - 1;
+
+  return arma::mat(out.data(), nvoxels, 3*values.n_cols);
+}
@@ -0,0 +1,10 @@
+#ifndef VOXEL_COUNTS_H
+#define VOXEL_COUNTS_H
+
+#include <RcppArmadillo.h>
+
+arma::mat voxel_counts_rcpp(arma::mat cloud, arma::vec edge_length, int threads = 1);
+Rcpp::List voxel_index_rcpp(arma::mat cloud, arma::vec edge_length, int threads = 1);
+arma::mat voxel_aggregate_rcpp(arma::mat values, Rcpp::IntegerVector start, Rcpp::IntegerVector points, int threads = 1);
+
+#endif
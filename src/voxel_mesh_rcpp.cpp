@@ -0,0 +1,50 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include "core/voxel_mesh.h"
+#include "core/threads.h"
+
+// [[Rcpp::export]]
+Rcpp::List voxel_mesh_rcpp(arma::mat voxels, arma::vec edge_length, bool cull = true, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  VoxelMesh mesh;
+
+  if (!voxel_mesh(voxels.colptr(0), voxels.colptr(1), voxels.colptr(2), voxels.n_rows, edge_length.memptr(), cull, mesh)) {
+    Rcpp::stop("edge_length is too small for the extent of the voxels");
+  }
+
+  int nfaces = mesh.voxel.size();
+  int nedges = mesh.edges.size()/6;
+
+  //Vertices by rows as in rgl
+  arma::mat quads(4*nfaces, 3);
+  Rcpp::IntegerVector voxel(nfaces);
+
+  for (int f = 0; f < nfaces; f++) {
+    for (int k = 0; k < 4; k++) {
+      for (int b = 0; b < 3; b++) {
+        quads(4*f + k, b) = mesh.quads[12*(size_t) f + 3*k + b];
+      }
+    }
+    voxel[f] = mesh.voxel[f] + 1;
+  }
+
+  arma::mat edges(2*nedges, 3);
+
+  for (int e = 0; e < nedges; e++) {
+    for (int k = 0; k < 2; k++) {
+      for (int b = 0; b < 3; b++) {
+        edges(2*e + k, b) = mesh.edges[6*(size_t) e + 3*k + b];
+      }
+    }
+  }
+
+  return Rcpp::List::create(Rcpp::Named("quads") = quads,
+                            Rcpp::Named("voxel") = voxel,
+                            Rcpp::Named("edges") = edges);
+}
@@ -0,0 +1,8 @@
+#ifndef VOXEL_MESH_H
+#define VOXEL_MESH_H
+
+#include <RcppArmadillo.h>
+
+Rcpp::List voxel_mesh_rcpp(arma::mat voxels, arma::vec edge_length, bool cull = true, int threads = 1);
+
+#endif
@@ -0,0 +1,208 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include <algorithm>
+#include <vector>
+#include "core/voxel_key.h"
+#include "core/threads.h"
+
+using namespace arma;
+
+//Open addressing table from voxel keys to slots
+struct VoxelTable {
+
+  std::vector<uint64_t> keys;
+  std::vector<int> slots;
+  uint64_t mask = 0;
+  int size = 0;
+
+  explicit VoxelTable(size_t expected) {
+    size_t capacity = 16;
+    while (capacity < 2*expected) {
+      capacity *= 2;
+    }
+    keys.assign(capacity, ~(uint64_t) 0);
+    slots.assign(capacity, -1);
+    mask = capacity - 1;
+  }
+
+  //Slot of a key, inserting it as slot "size" if it is new
+  int find(uint64_t key, uint64_t hash) {
+    uint64_t h = hash & mask;
+    while (slots[h] >= 0 && keys[h] != key) {
+      h = (h + 1) & mask;
+    }
+    if (slots[h] < 0) {
+      if (2*(size_t) (size + 1) > keys.size()) {
+        grow();
+        return find(key, hash);
+      }
+      keys[h] = key;
+      slots[h] = size++;
+    }
+    return slots[h];
+  }
+
+  void grow() {
+    VoxelTable bigger(keys.size());
+    for (size_t h = 0; h < keys.size(); h++) {
+      if (slots[h] >= 0) {
+        uint64_t g = voxel_hash(keys[h]) & bigger.mask;
+        while (bigger.slots[g] >= 0) {
+          g = (g + 1) & bigger.mask;
+        }
+        bigger.keys[g] = keys[h];
+        bigger.slots[g] = slots[h];
+      }
+    }
+    bigger.size = size;
+    *this = bigger;
+  }
+};
+
+// [[Rcpp::export]]
+Rcpp::IntegerVector voxel_subsample_rcpp(arma::mat cloud, arma::vec edge_length, int type = 0, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  int npoints = cloud.n_rows;
+
+  if (edge_length.n_elem != 3 || !(edge_length[0] > 0 && edge_length[1] > 0 && edge_length[2] > 0)) {
+    Rcpp::stop("edge_length needs three positive values");
+  }
+
+  if (npoints == 0) {
+    return Rcpp::IntegerVector(0);
+  }
+
+  const double* X = cloud.colptr(0);
+  const double* Y = cloud.colptr(1);
+  const double* Z = cloud.colptr(2);
+
+  double min[3] = {arma::min(cloud.col(0)), arma::min(cloud.col(1)), arma::min(cloud.col(2))};
+  double max[3] = {arma::max(cloud.col(0)), arma::max(cloud.col(1)), arma::max(cloud.col(2))};
+
+  for (int a = 0; a < 3; a++) {
+    if (voxel_index(max[a], min[a], edge_length[a]) >= VOXEL_KEY_MAX) {
+      Rcpp::stop("edge_length is too small for the extent of the cloud");
+    }
+  }
+
+  int nthreads = 1;
+#ifdef _OPENMP
+  nthreads = omp_get_max_threads();
+#endif
+
+  //Voxel key and hash of each point, and the bucket of its voxel
+  std::vector<uint64_t> key(npoints);
+  std::vector<uint64_t> hash(npoints);
+  std::vector<int> bucket(npoints);
+
+#pragma omp parallel for
+  for (int i = 0; i < npoints; i++) {
+    key[i] = voxel_key(voxel_index(X[i], min[0], edge_length[0]),
+                       voxel_index(Y[i], min[1], edge_length[1]),
+                       voxel_index(Z[i], min[2], edge_length[2]));
+    hash[i] = voxel_hash(key[i]);
+    bucket[i] = (hash[i] >> 40) % nthreads;
+  }
+
+  //Points of each bucket in the order of the cloud, so ties keep the lowest index
+  std::vector<int> offset(nthreads + 1, 0);
+  for (int i = 0; i < npoints; i++) {
+    offset[bucket[i] + 1]++;
+  }
+  for (int b = 0; b < nthreads; b++) {
+    offset[b + 1] += offset[b];
+  }
+
+  std::vector<int> order(npoints);
+  std::vector<int> next(offset.begin(), offset.end() - 1);
+  for (int i = 0; i < npoints; i++) {
+    order[next[bucket[i]]++] = i;
+  }
+
+  std::vector<std::vector<int>> selected(nthreads);
+
+  //Each bucket holds whole voxels, so they are reduced without a merge
+#pragma omp parallel for schedule(dynamic, 1)
+  for (int b = 0; b < nthreads; b++) {
+
+    VoxelTable table(offset[b + 1] - offset[b]);
+    std::vector<double> best;
+    std::vector<int> index;
+    std::vector<double> centroid;
+    std::vector<int> n;
+
+    //Sums of coordinates for the centroid
+    if (type == 1) {
+      for (int k = offset[b]; k < offset[b + 1]; k++) {
+        int i = order[k];
+        int slot = table.find(key[i], hash[i]);
+        if (slot == (int) n.size()) {
+          centroid.resize(3*(slot + 1), 0);
+          n.push_back(0);
+        }
+        centroid[3*slot] += X[i];
+        centroid[3*slot + 1] += Y[i];
+        centroid[3*slot + 2] += Z[i];
+        n[slot]++;
+      }
+      for (size_t s = 0; s < n.size(); s++) {
+        centroid[3*s] /= n[s];
+        centroid[3*s + 1] /= n[s];
+        centroid[3*s + 2] /= n[s];
+      }
+    }
+
+    for (int k = offset[b]; k < offset[b + 1]; k++) {
+
+      int i = order[k];
+      int slot = table.find(key[i], hash[i]);
+      double distance = 0;
+
+      if (type == 0) {
+        int64_t ix, iy, iz;
+        voxel_unkey(key[i], ix, iy, iz);
+        double dx = X[i] - (min[0] + ix*edge_length[0] + edge_length[0]/2);
+        double dy = Y[i] - (min[1] + iy*edge_length[1] + edge_length[1]/2);
+        double dz = Z[i] - (min[2] + iz*edge_length[2] + edge_length[2]/2);
+        distance = dx*dx + dy*dy + dz*dz;
+
+      } else if (type == 1) {
+        double dx = X[i] - centroid[3*slot];
+        double dy = Y[i] - centroid[3*slot + 1];
+        double dz = Z[i] - centroid[3*slot + 2];
+        distance = dx*dx + dy*dy + dz*dz;
+      }
+
+      if (slot == (int) best.size()) {
+        best.push_back(distance);
+        index.push_back(i);
+      } else if (distance < best[slot]) {
+        best[slot] = distance;
+        index[slot] = i;
+      }
+    }
+
+    selected[b].swap(index);
+  }
+
+  //Selected points in the order of the cloud
+  std::vector<int> all;
+  for (int t = 0; t < nthreads; t++) {
+    all.insert(all.end(), selected[t].begin(), selected[t].end());
+  }
+
+  std::sort(all.begin(), all.end());
+
+  Rcpp::IntegerVector out(all.size());
+  for (size_t i = 0; i < all.size(); i++) {
+    out[i] = all[i] + 1;
+  }
+
+  return out;
+}
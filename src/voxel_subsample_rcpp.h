@@ -0,0 +1,8 @@
+#ifndef VOXEL_SUBSAMPLE_H
+#define VOXEL_SUBSAMPLE_H
+
+#include <RcppArmadillo.h>
+
+Rcpp::IntegerVector voxel_subsample_rcpp(arma::mat cloud, arma::vec edge_length, int type = 0, int threads = 1);
+
+#endif
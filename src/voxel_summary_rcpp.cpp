@@ -0,0 +1,105 @@
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+// [[Rcpp::plugins(openmp)]]
+// [[Rcpp::depends(RcppArmadillo)]]
+#include <RcppArmadillo.h>
+#include "core/voxel_summary.h"
+#include "core/threads.h"
+
+//Columns of the statistics as in summary_voxels
+static void summary_row(const VoxelSummary& summary, arma::mat& summaries, int row) {
+  summaries(row, 0) = summary.n_voxels;
+  summaries(row, 1) = summary.volume;
+  summaries(row, 2) = summary.surface;
+  summaries(row, 3) = summary.density_mean;
+  summaries(row, 4) = std::isnan(summary.density_sd) ? NA_REAL : summary.density_sd;
+  summaries(row, 5) = summary.h;
+  summaries(row, 6) = summary.hmax;
+  summaries(row, 7) = summary.equitavility;
+  summaries(row, 8) = summary.negentropy;
+}
+
+// [[Rcpp::export]]
+arma::mat voxel_summary_rcpp(arma::mat cloud, arma::vec edge_sizes, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  int npoints = cloud.n_rows;
+  int nsizes = edge_sizes.n_elem;
+
+  arma::mat summaries(nsizes, 9);
+
+  for (int e = 0; e < nsizes; e++) {
+
+    double edge_length[3] = {edge_sizes[e], edge_sizes[e], edge_sizes[e]};
+
+    VoxelSummary summary;
+
+    if (!voxel_summary_points(cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), npoints, edge_length, summary)) {
+      Rcpp::stop("edge_length is too small for the extent of the cloud");
+    }
+
+    summary_row(summary, summaries, e);
+  }
+
+  return summaries;
+}
+
+// [[Rcpp::export]]
+arma::mat stand_summary_rcpp(arma::mat cloud, Rcpp::IntegerVector start, Rcpp::IntegerVector points, Rcpp::IntegerVector tiles,
+                             arma::mat edge_sizes, int threads = 1) {
+
+  ThreadGuard guard(threads);
+
+  int npoints = cloud.n_rows;
+  int ntiles = tiles.size();
+  int nsizes = edge_sizes.n_cols;
+
+  Voxels index;
+  index.start.assign(start.begin(), start.end());
+  index.points.resize(points.size());
+
+  for (int k = 0; k < points.size(); k++) {
+    if (points[k] < 1 || points[k] > npoints) {
+      Rcpp::stop("The index does not match the rows of the cloud");
+    }
+    index.points[k] = points[k] - 1;
+  }
+
+  if (index.start.empty() || index.start.back() != (int) index.points.size()) {
+    Rcpp::stop("The index does not match the rows of the cloud");
+  }
+
+  int nvoxels = index.start.size() - 1;
+
+  //Tiles as voxels of the index
+  std::vector<int> groups(ntiles);
+  for (int t = 0; t < ntiles; t++) {
+    if (tiles[t] < 1 || tiles[t] > nvoxels) {
+      Rcpp::stop("The tiles need to be voxels of the index");
+    }
+    groups[t] = tiles[t] - 1;
+  }
+
+  if ((int) edge_sizes.n_rows != ntiles) {
+    Rcpp::stop("edge_sizes needs a row per tile");
+  }
+
+  //Row major edge sizes of each tile
+  arma::mat edges = edge_sizes.t();
+
+  std::vector<VoxelSummary> results;
+
+  if (!voxel_summary_groups(cloud.colptr(0), cloud.colptr(1), cloud.colptr(2), index, groups, edges.memptr(), nsizes, results)) {
+    Rcpp::stop("edge_length is too small for the extent of the cloud");
+  }
+
+  arma::mat summaries((size_t) ntiles*nsizes, 9);
+
+  for (size_t r = 0; r < results.size(); r++) {
+    summary_row(results[r], summaries, r);
+  }
+
+  return summaries;
+}
@@ -0,0 +1,10 @@
+#ifndef VOXEL_SUMMARY_H
+#define VOXEL_SUMMARY_H
+
+#include <RcppArmadillo.h>
+
+arma::mat voxel_summary_rcpp(arma::mat cloud, arma::vec edge_sizes, int threads = 1);
+arma::mat stand_summary_rcpp(arma::mat cloud, Rcpp::IntegerVector start, Rcpp::IntegerVector points, Rcpp::IntegerVector tiles,
+                             arma::mat edge_sizes, int threads = 1);
+
+#endif
@@ -4,17 +4,14 @@
 // [[Rcpp::plugins(openmp)]]
 // [[Rcpp::depends(RcppArmadillo"]]
 #include <RcppArmadillo.h>
+#include "core/threads.h"
 
 using namespace arma;
 
 // [[Rcpp::export]]
 arma::mat voxelization_rcpp(arma::mat cloud, arma::vec edge_length, int threads = 1) {
 
-#ifdef _OPENMP
-  if ( threads > 0 ) {
-    omp_set_num_threads( threads );
-  }
-#endif
+  ThreadGuard guard(threads);
 
   double xmin = min(cloud.col(0));
   double ymin = min(cloud.col(1));
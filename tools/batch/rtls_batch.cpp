@@ -0,0 +1,456 @@
+//Batch processing of scans with the native routines of rTLS, without R.
+//
+//Each scan of a directory runs the pipeline filter -> voxels -> features ->
+//summary of voxels, and the results are written as CSV or binary files.
+//See README.md for the options and the formats.
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/features.h"
+#include "core/min_neighbors.h"
+#include "core/sor.h"
+#include "core/spatial_grid.h"
+#include "core/threads.h"
+#include "core/voxel_counts.h"
+#include "core/voxel_summary.h"
+
+namespace fs = std::filesystem;
+
+struct Options {
+  std::string input;
+  std::string output;
+  std::string format = "csv";
+  int threads = 1;
+  int jobs = 1;
+  int sor_k = 0;
+  double sor_sigma = 2;
+  double radius = 0;
+  int min_neighbours = 0;
+  double edge[3] = {0.1, 0.1, 0.1};
+  int k = 0;
+};
+
+struct Table {
+  std::vector<std::string> names;
+  std::vector<double> values; //By rows
+
+  size_t rows() const {
+    return names.empty() ? 0 : values.size()/names.size();
+  }
+};
+
+struct Result {
+  std::string scan;
+  std::string error;
+  int points = 0;
+  int kept = 0;
+  VoxelSummary summary;
+};
+
+static void usage() {
+  std::cerr <<
+    "Usage: rtls_batch --input=DIR --output=DIR [options]\n"
+    "  --format=csv|bin       Format of the outputs (csv)\n"
+    "  --threads=N            Threads of each routine (1, 0 for all)\n"
+    "  --jobs=N               Scans processed at once (1). With N > 1 each routine uses one thread\n"
+    "  --sor=K,SIGMA          Statistical outlier removal with K neighbors (off)\n"
+    "  --min-neighbors=R,N    Keep points with N neighbors within R (off)\n"
+    "  --voxel=E or EX,EY,EZ  Edge length of the voxels (0.1)\n"
+    "  --features=K           Eigenvalues of the K nearest neighbors of each point (off)\n";
+}
+
+static bool parse_numbers(const std::string& text, std::vector<double>& values) {
+  values.clear();
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    char* end = nullptr;
+    errno = 0;
+    double value = std::strtod(item.c_str(), &end);
+    if (item.empty() || *end != '\0' || errno != 0) {
+      return false;
+    }
+    values.push_back(value);
+  }
+  return !values.empty();
+}
+
+static bool parse_options(int argc, char** argv, Options& options) {
+
+  for (int a = 1; a < argc; a++) {
+
+    std::string arg = argv[a];
+    size_t eq = arg.find('=');
+
+    if (arg.compare(0, 2, "--") != 0 || eq == std::string::npos) {
+      std::cerr << "Unknown argument: " << arg << "\n";
+      return false;
+    }
+
+    std::string name = arg.substr(2, eq - 2);
+    std::string value = arg.substr(eq + 1);
+    std::vector<double> numbers;
+
+    if (name == "input") {
+      options.input = value;
+    } else if (name == "output") {
+      options.output = value;
+    } else if (name == "format" && (value == "csv" || value == "bin")) {
+      options.format = value;
+    } else if (name == "threads" && parse_numbers(value, numbers) && numbers.size() == 1 && numbers[0] >= 0) {
+      options.threads = numbers[0];
+    } else if (name == "jobs" && parse_numbers(value, numbers) && numbers.size() == 1 && numbers[0] >= 1) {
+      options.jobs = numbers[0];
+    } else if (name == "sor" && parse_numbers(value, numbers) && numbers.size() == 2 && numbers[0] >= 1) {
+      options.sor_k = numbers[0];
+      options.sor_sigma = numbers[1];
+    } else if (name == "min-neighbors" && parse_numbers(value, numbers) && numbers.size() == 2 && numbers[0] > 0) {
+      options.radius = numbers[0];
+      options.min_neighbours = numbers[1];
+    } else if (name == "voxel" && parse_numbers(value, numbers) && (numbers.size() == 1 || numbers.size() == 3)) {
+      for (int e = 0; e < 3; e++) {
+        options.edge[e] = numbers[numbers.size() == 1 ? 0 : e];
+        if (options.edge[e] <= 0) {
+          std::cerr << "The edge length of the voxels needs to be positive\n";
+          return false;
+        }
+      }
+    } else if (name == "features" && parse_numbers(value, numbers) && numbers.size() == 1 && numbers[0] > 3) {
+      options.k = numbers[0];
+    } else {
+      std::cerr << "Invalid argument: " << arg << "\n";
+      return false;
+    }
+  }
+
+  if (options.input.empty() || options.output.empty()) {
+    std::cerr << "--input and --output need to be defined\n";
+    return false;
+  }
+
+  return true;
+}
+
+//Binary tables start with "rTLSmat", a version, the number of rows and columns,
+//the names of the columns, and the values by rows as doubles of the machine
+static bool write_binary(const fs::path& file, const Table& table) {
+
+  std::ofstream out(file, std::ios::binary);
+  if (!out) {
+    return false;
+  }
+
+  uint32_t version = 1;
+  uint64_t rows = table.rows();
+  uint64_t cols = table.names.size();
+
+  out.write("rTLSmat", 8);
+  out.write((const char*) &version, sizeof(version));
+  out.write((const char*) &rows, sizeof(rows));
+  out.write((const char*) &cols, sizeof(cols));
+  for (const std::string& name : table.names) {
+    uint32_t length = name.size();
+    out.write((const char*) &length, sizeof(length));
+    out.write(name.data(), length);
+  }
+  out.write((const char*) table.values.data(), table.values.size()*sizeof(double));
+
+  return (bool) out;
+}
+
+static bool write_csv(const fs::path& file, const Table& table) {
+
+  FILE* out = std::fopen(file.string().c_str(), "w");
+  if (out == nullptr) {
+    return false;
+  }
+
+  size_t cols = table.names.size();
+
+  for (size_t c = 0; c < cols; c++) {
+    std::fprintf(out, c == 0 ? "%s" : ",%s", table.names[c].c_str());
+  }
+  std::fprintf(out, "\n");
+
+  for (size_t r = 0; r < table.rows(); r++) {
+    for (size_t c = 0; c < cols; c++) {
+      std::fprintf(out, c == 0 ? "%.10g" : ",%.10g", table.values[r*cols + c]);
+    }
+    std::fprintf(out, "\n");
+  }
+
+  return std::fclose(out) == 0;
+}
+
+static bool write_table(const fs::path& file, const Table& table, const std::string& format) {
+  return format == "bin" ? write_binary(file, table) : write_csv(file, table);
+}
+
+//Scans are text files with XYZ in the first three columns separated by commas,
+//semicolons, spaces or tabs, or binary tables written by this program. Lines
+//that do not start with three numbers (e.g. headers) are skipped.
+static bool read_scan(const fs::path& file, std::vector<double>& X, std::vector<double>& Y, std::vector<double>& Z) {
+
+  X.clear();
+  Y.clear();
+  Z.clear();
+
+  if (file.extension() == ".bin") {
+
+    std::ifstream in(file, std::ios::binary);
+    char magic[8];
+    uint32_t version = 0;
+    uint64_t rows = 0, cols = 0;
+
+    in.read(magic, 8);
+    in.read((char*) &version, sizeof(version));
+    in.read((char*) &rows, sizeof(rows));
+    in.read((char*) &cols, sizeof(cols));
+    if (!in || std::memcmp(magic, "rTLSmat", 8) != 0 || version != 1 || cols < 3) {
+      return false;
+    }
+
+    for (uint64_t c = 0; c < cols; c++) {
+      uint32_t length = 0;
+      in.read((char*) &length, sizeof(length));
+      in.ignore(length);
+    }
+
+    std::vector<double> row(cols);
+    for (uint64_t r = 0; r < rows && in; r++) {
+      in.read((char*) row.data(), cols*sizeof(double));
+      X.push_back(row[0]);
+      Y.push_back(row[1]);
+      Z.push_back(row[2]);
+    }
+
+    return (bool) in;
+  }
+
+  std::ifstream in(file);
+  if (!in) {
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(in, line)) {
+
+    const char* p = line.c_str();
+    double xyz[3];
+    int found = 0;
+
+    while (found < 3) {
+      while (*p == ',' || *p == ';' || *p == ' ' || *p == '\t') {
+        p++;
+      }
+      char* end = nullptr;
+      xyz[found] = std::strtod(p, &end);
+      if (end == p) {
+        break;
+      }
+      p = end;
+      found++;
+    }
+
+    if (found == 3) {
+      X.push_back(xyz[0]);
+      Y.push_back(xyz[1]);
+      Z.push_back(xyz[2]);
+    }
+  }
+
+  return true;
+}
+
+static Result process_scan(const fs::path& file, const Options& options) {
+
+  Result result;
+  result.scan = file.stem().string();
+
+  std::vector<double> X, Y, Z;
+
+  if (!read_scan(file, X, Y, Z)) {
+    result.error = "the scan could not be read";
+    return result;
+  }
+
+  result.points = X.size();
+
+  if (result.points < 2) {
+    result.error = "the scan has less than two points";
+    return result;
+  }
+
+  //Filters
+  std::vector<char> keep(result.points, 1);
+
+  if (options.sor_k > 0) {
+    if (options.sor_k >= result.points) {
+      result.error = "the neighbors of --sor need to be less than the points of the scan";
+      return result;
+    }
+    SpatialGrid grid(X.data(), Y.data(), Z.data(), result.points);
+    sor_filter(grid, options.sor_k, options.sor_sigma, keep);
+  }
+
+  if (options.min_neighbours > 0) {
+    double cell = options.radius/std::sqrt(3.0);
+    SpatialGrid grid(X.data(), Y.data(), Z.data(), result.points, cell);
+    std::vector<char> neighbors;
+    min_neighbors(grid, options.radius, options.min_neighbours, grid.cell == cell, neighbors);
+    for (int i = 0; i < result.points; i++) {
+      keep[i] = keep[i] && neighbors[i];
+    }
+  }
+
+  int kept = 0;
+  for (int i = 0; i < result.points; i++) {
+    if (keep[i]) {
+      X[kept] = X[i];
+      Y[kept] = Y[i];
+      Z[kept] = Z[i];
+      kept++;
+    }
+  }
+
+  X.resize(kept);
+  Y.resize(kept);
+  Z.resize(kept);
+  result.kept = kept;
+
+  if (kept == 0) {
+    result.error = "no points were kept by the filters";
+    return result;
+  }
+
+  //Voxels
+  Voxels voxels;
+
+  if (!voxel_counts(X.data(), Y.data(), Z.data(), kept, options.edge, voxels)) {
+    result.error = "the edge length of the voxels is too small for the extent of the scan";
+    return result;
+  }
+
+  result.summary = voxel_summary(voxels);
+
+  Table voxel_table;
+  voxel_table.names = {"X", "Y", "Z", "N"};
+  for (size_t v = 0; v < voxels.n.size(); v++) {
+    voxel_table.values.insert(voxel_table.values.end(), {voxels.x[v], voxels.y[v], voxels.z[v], (double) voxels.n[v]});
+  }
+
+  fs::path base = fs::path(options.output) / result.scan;
+
+  if (!write_table(base.string() + "_voxels." + options.format, voxel_table, options.format)) {
+    result.error = "the voxels could not be written";
+    return result;
+  }
+
+  //Points with their features
+  Table point_table;
+  point_table.names = {"X", "Y", "Z"};
+
+  std::vector<double> features;
+
+  if (options.k > 0) {
+    if (options.k > kept) {
+      result.error = "the neighbors of --features need to be less than the points kept";
+      return result;
+    }
+    SpatialGrid grid(X.data(), Y.data(), Z.data(), kept);
+    knn_features(grid, options.k, features);
+    point_table.names.insert(point_table.names.end(), {"eig1", "eig2", "eig3"});
+  }
+
+  for (int i = 0; i < kept; i++) {
+    point_table.values.insert(point_table.values.end(), {X[i], Y[i], Z[i]});
+    if (options.k > 0) {
+      point_table.values.insert(point_table.values.end(), features.begin() + 3*(size_t) i, features.begin() + 3*(size_t) i + 3);
+    }
+  }
+
+  if (!write_table(base.string() + "_points." + options.format, point_table, options.format)) {
+    result.error = "the points could not be written";
+  }
+
+  return result;
+}
+
+int main(int argc, char** argv) {
+
+  Options options;
+
+  if (!parse_options(argc, argv, options)) {
+    usage();
+    return 2;
+  }
+
+  std::error_code code;
+  std::vector<fs::path> scans;
+
+  for (const fs::directory_entry& entry : fs::directory_iterator(options.input, code)) {
+    std::string extension = entry.path().extension().string();
+    if (entry.is_regular_file() && (extension == ".txt" || extension == ".csv" || extension == ".xyz" || extension == ".bin")) {
+      scans.push_back(entry.path());
+    }
+  }
+
+  if (code) {
+    std::cerr << "The input directory could not be read: " << code.message() << "\n";
+    return 2;
+  }
+
+  std::sort(scans.begin(), scans.end());
+  fs::create_directories(options.output, code);
+
+  int nscans = scans.size();
+  std::vector<Result> results(nscans);
+
+  //Scans in parallel run each routine on one thread, see ThreadGuard
+  ThreadGuard guard(options.threads);
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(options.jobs)
+  for (int s = 0; s < nscans; s++) {
+    ThreadGuard scan_guard(options.threads);
+    results[s] = process_scan(scans[s], options);
+#pragma omp critical
+    std::cerr << results[s].scan << ": " << (results[s].error.empty() ? "done" : results[s].error) << "\n";
+  }
+
+  //Summary of the voxels of each scan
+  FILE* out = std::fopen((fs::path(options.output) / "summary.csv").string().c_str(), "w");
+  if (out == nullptr) {
+    std::cerr << "The summary could not be written\n";
+    return 1;
+  }
+
+  std::fprintf(out, "Scan,Points,Kept,Edge.X,Edge.Y,Edge.Z,N_voxels,Volume,Surface,Density_mean,Density_sd,H,Hmax,Equitavility,Negentropy\n");
+
+  int failed = 0;
+
+  for (const Result& r : results) {
+    if (!r.error.empty()) {
+      failed++;
+      continue;
+    }
+    const VoxelSummary& v = r.summary;
+    std::fprintf(out, "%s,%d,%d,%.10g,%.10g,%.10g,%d,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g\n",
+                 r.scan.c_str(), r.points, r.kept, options.edge[0], options.edge[1], options.edge[2],
+                 v.n_voxels, v.volume, v.surface, v.density_mean, v.density_sd, v.h, v.hmax, v.equitavility, v.negentropy);
+  }
+
+  std::fclose(out);
+
+  return failed > 0 ? 1 : 0;
+}